@@ -0,0 +1,16 @@
+#include "area_damage.h"
+
+static void queueHits(DamageQueue& q, int dmg) {
+    for (Uint32 id : q.found) pushDamage(q, id, 0, dmg, DAMAGE_AREA);
+    q.found.clear();
+}
+
+void areaCircle(DamageQueue& q, const SpatialGrid& grid, Vec2 center, float radius, int dmg) {
+    gridQueryCircle(grid, center, radius, q.found);
+    queueHits(q, dmg);
+}
+
+void areaCone(DamageQueue& q, const SpatialGrid& grid, Vec2 origin, Vec2 dir, float radius, float halfAngle, int dmg) {
+    gridQueryCone(grid, origin, dir, radius, halfAngle, q.found);
+    queueHits(q, dmg);
+}
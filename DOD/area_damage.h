@@ -0,0 +1,9 @@
+#pragma once
+
+#include "damage_events.h"
+#include "spatial_grid.h"
+
+// Area attacks (explosions, melee swings): every mob in the shape gets a DAMAGE_AREA event.
+// Grid ids must be indices into the mob array the queue is resolved against.
+void areaCircle(DamageQueue& q, const SpatialGrid& grid, Vec2 center, float radius, int dmg);
+void areaCone(DamageQueue& q, const SpatialGrid& grid, Vec2 origin, Vec2 dir, float radius, float halfAngle, int dmg);
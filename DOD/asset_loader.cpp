@@ -0,0 +1,121 @@
+#include "asset_loader.h"
+
+#include <algorithm>
+#include <cstdio>
+
+static Asset& addAsset(AssetLoader& loader, AssetKind kind, const char* path) {
+    loader.assets.push_back(Asset());
+    Asset& a = loader.assets.back();
+    a.kind = kind;
+    SDL_strlcpy(a.path, path, sizeof(a.path));
+    const char* file = SDL_strrchr(path, '/');
+    SDL_strlcpy(a.name, file ? file + 1 : path, sizeof(a.name));
+    char* dot = SDL_strrchr(a.name, '.');
+    if (dot) *dot = '\0';
+    return a;
+}
+
+int assetLoaderAddFile(AssetLoader& loader, const char* path) {
+    addAsset(loader, ASSET_FILE, path);
+    return (int)loader.assets.size() - 1;
+}
+
+int assetLoaderAddImages(AssetLoader& loader, const char* dir, const char* pattern) {
+    int count = 0;
+    char** files = SDL_GlobDirectory(dir, pattern, 0, &count);
+    for (int i = 0; files && i < count; ++i) {
+        char path[256];
+        SDL_snprintf(path, sizeof(path), "%s/%s", dir, files[i]);
+        addAsset(loader, ASSET_IMAGE, path);
+    }
+    SDL_free(files);
+    return files ? count : 0;
+}
+
+static void loadAsset(Asset& a) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    SDL_IOStream* io = SDL_IOFromFile(a.path, "rb");
+    if (io && a.kind == ASSET_FILE) {
+        a.data = (char*)SDL_LoadFile_IO(io, &a.size, true);
+        a.ok = a.data != nullptr;
+    }
+    else if (io) {
+        SDL_Surface* loaded = SDL_LoadBMP_IO(io, true);
+        a.image = loaded ? SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32) : nullptr;
+        SDL_DestroySurface(loaded);
+        a.ok = a.image != nullptr;
+        if (a.image) a.size = (size_t)a.image->pitch * a.image->h;
+    }
+    if (!a.ok) printf("%s: %s\n", a.path, SDL_GetError());
+    a.loadMs = (float)((SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+
+// lock-free push (Treiber stack), any number of loader threads
+static void pushCompleted(AssetLoader& loader, Asset* a) {
+    void* head;
+    do {
+        head = SDL_GetAtomicPointer(&loader.completed);
+        a->next = (Asset*)head;
+    } while (!SDL_CompareAndSwapAtomicPointer(&loader.completed, head, a));
+}
+
+static int SDLCALL loaderMain(void* data) {
+    AssetLoader& loader = *(AssetLoader*)data;
+    while (true) {
+        int i = SDL_AddAtomicInt(&loader.nextRequest, 1);
+        if (i >= (int)loader.assets.size()) break;
+        loadAsset(loader.assets[i]);
+        pushCompleted(loader, &loader.assets[i]);
+    }
+    return 0;
+}
+
+bool assetLoaderStart(AssetLoader& loader, int threads) {
+    loader.startTicks = SDL_GetPerformanceCounter();
+    SDL_SetAtomicInt(&loader.nextRequest, 0);
+    if (threads <= 0) threads = SDL_min((int)loader.assets.size(), SDL_max(1, SDL_GetNumLogicalCPUCores()));
+    for (int i = 0; i < threads; ++i) {
+        SDL_Thread* t = SDL_CreateThread(loaderMain, "assets", &loader);
+        if (!t) {
+            printf("Asset thread create failed: %s\n", SDL_GetError());
+            break;
+        }
+        loader.threads.push_back(t);
+    }
+    if (loader.threads.empty() && !loader.assets.empty()) {
+        // no threads, load everything here so the caller still gets its assets
+        loaderMain(&loader);
+    }
+    return !loader.threads.empty();
+}
+
+int assetLoaderPoll(AssetLoader& loader, std::vector<Asset*>& out) {
+    Asset* list = (Asset*)SDL_SetAtomicPointer(&loader.completed, nullptr);
+    size_t first = out.size();
+    for (Asset* a = list; a; a = a->next) {
+        out.push_back(a);
+        loader.bytesLoaded += a->size;
+    }
+    // the stack is newest first
+    std::reverse(out.begin() + first, out.end());
+    int n = (int)(out.size() - first);
+    loader.finished += n;
+    if (n > 0 && assetLoaderDone(loader)) {
+        loader.wallMs = (float)((SDL_GetPerformanceCounter() - loader.startTicks) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+    }
+    return n;
+}
+
+void assetLoaderShutdown(AssetLoader& loader) {
+    for (SDL_Thread* t : loader.threads) SDL_WaitThread(t, nullptr);
+    loader.threads.clear();
+    for (Asset& a : loader.assets) {
+        SDL_free(a.data);
+        SDL_DestroySurface(a.image);
+        a.data = nullptr;
+        a.image = nullptr;
+    }
+    loader.assets.clear();
+    loader.completed = nullptr;
+    loader.finished = 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <vector>
+
+// Background asset loading. Files are read (and images decoded) through SDL_IOStream on a few
+// loader threads; every finished asset is pushed on a lock-free queue that the main thread
+// drains once per frame, so the window comes up right away and the total load time is the
+// slowest file instead of the sum of all of them.
+enum AssetKind {
+    ASSET_FILE,   // raw bytes, NUL terminated (text parsers work in place)
+    ASSET_IMAGE,  // BMP decoded to RGBA32
+};
+
+struct Asset {
+    AssetKind kind = ASSET_FILE;
+    char path[256];
+    char name[32]; // file name without extension
+    bool ok = false;
+
+    char* data = nullptr;
+    size_t size = 0;
+    SDL_Surface* image = nullptr;
+    float loadMs = 0.0f; // on the loader thread, read + decode
+
+    Asset* next = nullptr; // completion queue link
+};
+
+struct AssetLoader {
+    std::vector<Asset> assets; // fixed once started, indices returned by the add functions
+    std::vector<SDL_Thread*> threads;
+    SDL_AtomicInt nextRequest{};
+    void* completed = nullptr; // Asset* stack, pushed by loader threads with CAS
+    int finished = 0;          // drained by the main thread
+    size_t bytesLoaded = 0;
+    Uint64 startTicks = 0;
+    float wallMs = 0.0f;       // start until the last asset was drained
+};
+
+int assetLoaderAddFile(AssetLoader& loader, const char* path);
+// every file in dir matching pattern (e.g. "*.bmp"), returns how many were queued
+int assetLoaderAddImages(AssetLoader& loader, const char* dir, const char* pattern);
+
+// threads <= 0: one per asset, capped by the logical core count
+bool assetLoaderStart(AssetLoader& loader, int threads = 0);
+
+// Moves the assets finished since the last call to `out`, in completion order. Main thread only.
+int assetLoaderPoll(AssetLoader& loader, std::vector<Asset*>& out);
+
+static inline bool assetLoaderDone(const AssetLoader& loader) {
+    return loader.finished == (int)loader.assets.size();
+}
+static inline float assetLoaderProgress(const AssetLoader& loader) {
+    return loader.assets.empty() ? 1.0f : (float)loader.finished / (float)loader.assets.size();
+}
+
+// joins the loader threads and frees every asset
+void assetLoaderShutdown(AssetLoader& loader);
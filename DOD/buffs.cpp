@@ -0,0 +1,73 @@
+#include "buffs.h"
+
+// the first five keep the old pickups, the timed ones wear off
+const BuffEffect BUFF_EFFECTS[] = {
+    { "fire rate", { 255, 0, 0, 255 }, BUFF_MODIFIER, STAT_FIRE_RATE, STAT_MUL, 1.2f, 0.0f },
+    { "bullet speed", { 0, 255, 0, 255 }, BUFF_MODIFIER, STAT_BULLET_SPEED, STAT_MUL, 1.2f, 0.0f },
+    { "heal", { 0, 0, 255, 255 }, BUFF_HEAL, 0, 0, 10.0f, 0.0f },
+    { "fire mode", { 255, 255, 0, 255 }, BUFF_TOGGLE_AUTOSHOOT, 0, 0, 0.0f, 0.0f },
+    { "bullet damage", { 255, 0, 255, 255 }, BUFF_MODIFIER, STAT_BULLET_DAMAGE, STAT_ADD, 2.0f, 0.0f },
+    { "frenzy", { 255, 140, 0, 255 }, BUFF_MODIFIER, STAT_FIRE_RATE, STAT_MUL, 2.0f, 8.0f },
+    { "haste", { 0, 255, 255, 255 }, BUFF_MODIFIER, STAT_MOVE_SPEED, STAT_MUL, 1.5f, 6.0f },
+};
+const int BUFF_EFFECT_COUNT = (int)SDL_arraysize(BUFF_EFFECTS);
+
+void initBuffPool(BuffPool& p, int capacity) {
+    p.capacity = capacity;
+    p.rect.resize(capacity);
+    p.effect.resize(capacity);
+    p.life.resize(capacity);
+    clearBuffPool(p);
+}
+
+void clearBuffPool(BuffPool& p) {
+    p.count = 0;
+}
+
+bool spawnBuff(BuffPool& p, const SDL_FRect& rect, Uint8 effect) {
+    if (p.count == p.capacity) return false;
+    int i = p.count++;
+    p.rect[i] = rect;
+    p.effect[i] = effect;
+    p.life[i] = p.lifetime;
+    return true;
+}
+
+static void removeBuff(BuffPool& p, int i) {
+    int last = --p.count;
+    p.rect[i] = p.rect[last];
+    p.effect[i] = p.effect[last];
+    p.life[i] = p.life[last];
+}
+
+void updateBuffPool(BuffPool& p, const SDL_FRect& player, float dt, std::vector<Uint8>& out) {
+    out.clear();
+    for (int i = 0; i < p.count;) {
+        if (aabb(player, p.rect[i])) {
+            out.push_back(p.effect[i]);
+            removeBuff(p, i);
+            continue;
+        }
+        if ((p.life[i] -= dt) <= 0.0f) {
+            removeBuff(p, i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+void applyBuffEffect(const BuffEffect& e, StatStack& stats, int& hp, bool& autoShoot) {
+    switch (e.kind) {
+        case BUFF_MODIFIER: addStatModifier(stats, e.stat, e.op, e.magnitude, e.duration); break;
+        case BUFF_HEAL: hp += (int)e.magnitude; break;
+        case BUFF_TOGGLE_AUTOSHOOT: autoShoot = !autoShoot; break;
+    }
+}
+
+void buffsToSnapshot(const BuffPool& p, RenderSnapshot& s, const std::vector<Uint32>& visible, Uint16 sprite) {
+    for (Uint32 i : visible) {
+        SDL_Color c = BUFF_EFFECTS[p.effect[i]].color;
+        if (p.life[i] < 3.0f && ((int)(p.life[i] * 8.0f) & 1)) c.a = 96; // blinks before despawning
+        snapshotAddRect(s, p.rect[i], c, sprite);
+    }
+}
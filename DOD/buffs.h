@@ -0,0 +1,52 @@
+#pragma once
+
+#include "entities.h"
+#include "render_snapshot.h"
+#include "stat_mods.h"
+
+#include <vector>
+
+enum BuffKind : Uint8 {
+    BUFF_MODIFIER = 0, // pushes a stat modifier (timed or permanent)
+    BUFF_HEAL,         // instant hp
+    BUFF_TOGGLE_AUTOSHOOT,
+};
+
+// One row per pickup type; the spawner picks rows uniformly.
+struct BuffEffect {
+    const char* name;
+    SDL_Color color;
+    Uint8 kind;
+    Uint8 stat; // BUFF_MODIFIER only
+    Uint8 op;
+    float magnitude;
+    float duration; // seconds, 0: permanent
+};
+
+extern const BuffEffect BUFF_EFFECTS[];
+extern const int BUFF_EFFECT_COUNT;
+
+// Buff pickups on the ground. Fixed capacity, dense arrays with swap-remove on pickup or
+// expiry, so every loop only touches live pickups.
+struct BuffPool {
+    int capacity = 0;
+    int count = 0;
+    std::vector<SDL_FRect> rect;
+    std::vector<Uint8> effect; // index into BUFF_EFFECTS
+    std::vector<float> life;   // seconds until it despawns
+
+    float lifetime = 40.0f;
+};
+
+void initBuffPool(BuffPool& p, int capacity);
+void clearBuffPool(BuffPool& p);
+
+// false when the pool is full
+bool spawnBuff(BuffPool& p, const SDL_FRect& rect, Uint8 effect);
+
+// ages the pickups and removes the ones touching the player, their effects go to out
+void updateBuffPool(BuffPool& p, const SDL_FRect& player, float dt, std::vector<Uint8>& out);
+
+void applyBuffEffect(const BuffEffect& e, StatStack& stats, int& hp, bool& autoShoot);
+
+void buffsToSnapshot(const BuffPool& p, RenderSnapshot& s, const std::vector<Uint32>& visible, Uint16 sprite);
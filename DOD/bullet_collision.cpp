@@ -0,0 +1,97 @@
+#include "bullet_collision.h"
+
+#include "jobs.h"
+
+#include <algorithm>
+
+// Points the bullet at the closest mob it has not hit yet, bounces off the mob it just hit
+// when nothing is in range.
+static void ricochet(Bullet& b, const SDL_FRect& mob, const SpatialGrid& grid, float range) {
+    Vec2 c{ b.rect.x + b.rect.w * 0.5f, b.rect.y + b.rect.h * 0.5f };
+    float speed = std::sqrt(b.velocity.x * b.velocity.x + b.velocity.y * b.velocity.y);
+
+    NearestHit near[BULLET_HIT_SLOTS + 1];
+    int n = gridKNearest(grid, c, range, BULLET_HIT_SLOTS + 1, near);
+    for (int i = 0; i < n; ++i) {
+        if (bulletHitsContains(b.hits, near[i].id)) continue;
+        Vec2 d = normalize({ near[i].pos.x - c.x, near[i].pos.y - c.y });
+        if (d.x == 0.0f && d.y == 0.0f) continue;
+        b.velocity = { d.x * speed, d.y * speed };
+        return;
+    }
+
+    // reflect on the axis with the smaller penetration
+    float dx = (c.x - (mob.x + mob.w * 0.5f)) / std::max(1.0f, mob.w);
+    float dy = (c.y - (mob.y + mob.h * 0.5f)) / std::max(1.0f, mob.h);
+    if (std::fabs(dx) > std::fabs(dy)) b.velocity.x = dx > 0.0f ? std::fabs(b.velocity.x) : -std::fabs(b.velocity.x);
+    else b.velocity.y = dy > 0.0f ? std::fabs(b.velocity.y) : -std::fabs(b.velocity.y);
+}
+
+void detectBulletHits(BulletCollision& bc, std::vector<Bullet>& bullets, const SpatialGrid& grid,
+                      DamageQueue& q, int dmg) {
+    const int grain = 128;
+    int count = (int)bullets.size();
+    int chunkCount = count / grain + 1;
+    bc.chunkCandidates.assign(chunkCount, 0);
+    damageBeginChunks(q, chunkCount);
+
+    parallelFor(count, grain, [&](int begin, int end) {
+        std::vector<DamageEvent>& events = q.chunks[begin / grain];
+        std::vector<Uint32> found;
+        int candidates = 0;
+        for (int i = begin; i < end; ++i) {
+            Bullet& b = bullets[i];
+            if (!b.alive) continue;
+            Vec2 c{ b.rect.x + b.rect.w * 0.5f, b.rect.y + b.rect.h * 0.5f };
+            // any mob whose rect can overlap the bullet has its center within this radius
+            float reach = (std::max(b.rect.w, b.rect.h) + bc.maxMobSize) * 0.7072f;
+            found.clear();
+            gridQueryCircle(grid, c, reach, found);
+            candidates += (int)found.size();
+            std::sort(found.begin(), found.end()); // grid order is not stable between frames
+
+            int n = 0;
+            for (Uint32 mob : found) {
+                if (n == BULLET_MAX_FRAME_HITS) break;
+                if (!aabb(b.rect, bc.mobRects[mob]) || bulletHitsContains(b.hits, mob)) continue;
+                bulletHitsAdd(b.hits, mob);
+                events.push_back({ mob, (Uint32)i, dmg, DAMAGE_BULLET });
+                ++n;
+                if (b.pierce > 0) {
+                    b.pierce--;
+                }
+                else if (b.bounces > 0) {
+                    b.bounces--;
+                    ricochet(b, bc.mobRects[mob], grid, bc.ricochetRange);
+                    break;
+                }
+                else {
+                    b.alive = false;
+                    break;
+                }
+            }
+        }
+        bc.chunkCandidates[begin / grain] = candidates;
+    });
+
+    bc.candidates = 0;
+    bc.hits = 0;
+    for (int c = 0; c < chunkCount; ++c) {
+        bc.candidates += bc.chunkCandidates[c];
+        bc.hits += (int)q.chunks[c].size();
+    }
+}
+
+void remapBulletHits(std::vector<Bullet>& bullets, const std::vector<Uint32>& remap) {
+    for (Bullet& b : bullets) {
+        if (!b.alive || b.hits.count == 0) continue;
+        // keep the surviving entries in order
+        BulletHits kept;
+        for (int k = 0; k < b.hits.count; ++k) {
+            Uint32 mob = b.hits.mob[k];
+            Uint32 to = mob < remap.size() ? remap[mob] : GRID_NONE;
+            if (to != GRID_NONE) bulletHitsAdd(kept, to);
+        }
+        b.hits = kept;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "damage_events.h"
+#include "spatial_grid.h"
+
+#include <vector>
+
+static const int BULLET_MAX_FRAME_HITS = 8; // new mobs one bullet can touch in a frame
+
+// Bullet vs mob detection, run over the bullets in parallel against the mob grid. Each bullet
+// only writes its own state (hit history, pierce/bounce counters, velocity, alive); hits become
+// DAMAGE_BULLET events in the queue's chunk buffers, applied later by resolveDamage.
+struct BulletCollision {
+    std::vector<SDL_FRect> mobRects; // indexed like the grid ids, filled by the caller
+    float maxMobSize = 0.0f;
+    float ricochetRange = 300.0f;
+
+    // stats of the last detect
+    int candidates = 0;
+    int hits = 0;
+
+    // per chunk scratch
+    std::vector<int> chunkCandidates;
+};
+
+void detectBulletHits(BulletCollision& bc, std::vector<Bullet>& bullets, const SpatialGrid& grid,
+                      DamageQueue& q, int dmg);
+
+// remap[old mob index] = new index or GRID_NONE, call before the mob array is compacted
+void remapBulletHits(std::vector<Bullet>& bullets, const std::vector<Uint32>& remap);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "damage_numbers.h"
+#include "particles.h"
+
+// Feedback hooked into the collision code: sparks + a damage number on each bullet hit,
+// a burst when a mob dies, bursts/arcs for area attacks. Either pointer may be nullptr
+// (effect switched off).
+struct CombatFx {
+    ParticleSystem* particles = nullptr;
+    DamageNumbers* numbers = nullptr;
+};
+
+static inline void fxBulletHit(const CombatFx& fx, const Entity& bullet, const SDL_FRect& mob, SDL_Color mobColor, int dmg) {
+    if (fx.particles) emitHitSparks(*fx.particles, bullet.rect, bullet.velocity, mobColor);
+    if (fx.numbers) addDamageNumber(*fx.numbers, mob.x + mob.w * 0.5f, mob.y, dmg);
+}
+
+static inline void fxMobDeath(const CombatFx& fx, const SDL_FRect& mob, SDL_Color mobColor) {
+    if (fx.particles) emitDeathBurst(*fx.particles, mob, mobColor);
+}
+
+// area hits only show the number, sparks per mob would swamp the particle pool
+static inline void fxAreaHit(const CombatFx& fx, const SDL_FRect& mob, int dmg) {
+    if (fx.numbers) addDamageNumber(*fx.numbers, mob.x + mob.w * 0.5f, mob.y, dmg);
+}
+
+static inline void fxExplosion(const CombatFx& fx, Vec2 center, float radius) {
+    if (fx.particles) emitParticles(*fx.particles, center.x, center.y, 24 + (int)(radius * 0.25f), 1.0f, 0.0f, 7.0f,
+                                    radius * 1.5f, radius * 3.0f, 0.3f, 5.0f, { 255, 160, 60, 255 });
+}
+
+static inline void fxSwing(const CombatFx& fx, Vec2 origin, Vec2 dir, float radius, float halfAngle) {
+    if (fx.particles) emitParticles(*fx.particles, origin.x, origin.y, 20, dir.x, dir.y, halfAngle * 2.0f,
+                                    radius * 2.5f, radius * 3.5f, 0.25f, 3.0f, { 230, 230, 255, 255 });
+}
@@ -0,0 +1,30 @@
+#include "cull.h"
+
+#include <SDL3/SDL_intrin.h>
+
+void cullRects(const SDL_FRect* first, size_t stride, size_t count, const SDL_FRect& view,
+               std::vector<Uint32>& out) {
+    out.resize(count);
+    Uint32* dst = out.data();
+    size_t n = 0;
+    const Uint8* p = (const Uint8*)first;
+
+#ifdef SDL_SSE2_INTRINSICS
+    // visible <=> (x, y, -(x + w), -(y + h)) < (vx + vw, vy + vh, -vx, -vy) on all lanes
+    const __m128 bound = _mm_setr_ps(view.x + view.w, view.y + view.h, -view.x, -view.y);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (size_t i = 0; i < count; ++i, p += stride) {
+        __m128 r = _mm_loadu_ps((const float*)p);                             // x y w h
+        __m128 hi = _mm_add_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 2, 3, 2))); // x+w y+h . .
+        __m128 lhs = _mm_movelh_ps(r, _mm_xor_ps(hi, sign));                  // x y -(x+w) -(y+h)
+        dst[n] = (Uint32)i;
+        n += _mm_movemask_ps(_mm_cmplt_ps(lhs, bound)) == 0xF;
+    }
+#else
+    for (size_t i = 0; i < count; ++i, p += stride) {
+        dst[n] = (Uint32)i;
+        n += aabb(*(const SDL_FRect*)p, view);
+    }
+#endif
+    out.resize(n);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "entities.h"
+
+#include <vector>
+
+// View culling: compact lists of the indices that overlap the view, one per entity kind.
+// The snapshot is built from these, so off-screen mobs (e.g. freshly spawned at the edges)
+// never reach the renderer.
+enum CullKind {
+    CULL_MOBS = 0,
+    CULL_BULLETS,
+    CULL_BUFFS,
+    CULL_KIND_COUNT
+};
+
+struct VisibleSet {
+    std::vector<Uint32> indices[CULL_KIND_COUNT];
+    int total[CULL_KIND_COUNT] = {};
+};
+
+// Overwrites `out` with the indices i < count whose rect overlaps `view` (same test as aabb).
+// Rects are read at `first + i * stride`, so this works on any array of structs that has an
+// SDL_FRect member. SSE2 tests one rect per instruction, scalar fallback otherwise.
+void cullRects(const SDL_FRect* first, size_t stride, size_t count, const SDL_FRect& view,
+               std::vector<Uint32>& out);
+
+template <typename T>
+void cullEntities(const std::vector<T>& items, const SDL_FRect& view, std::vector<Uint32>& out) {
+    if (items.empty()) { out.clear(); return; }
+    cullRects(&items[0].rect, sizeof(T), items.size(), view, out);
+}
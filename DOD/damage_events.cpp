@@ -0,0 +1,88 @@
+#include "damage_events.h"
+
+#include <algorithm>
+
+void damageBeginChunks(DamageQueue& q, int chunkCount) {
+    if ((int)q.chunks.size() < chunkCount) q.chunks.resize(chunkCount);
+    for (std::vector<DamageEvent>& c : q.chunks) c.clear();
+}
+
+static void mergeAndSort(DamageQueue& q) {
+    // chunk events first (bullets), then the serial ones, in the order they were produced
+    size_t chunked = 0;
+    for (const std::vector<DamageEvent>& c : q.chunks) chunked += c.size();
+    if (chunked) {
+        q.events.insert(q.events.begin(), chunked, DamageEvent());
+        size_t at = 0;
+        for (std::vector<DamageEvent>& c : q.chunks) {
+            std::copy(c.begin(), c.end(), q.events.begin() + at);
+            at += c.size();
+            c.clear();
+        }
+    }
+    std::stable_sort(q.events.begin(), q.events.end(),
+                     [](const DamageEvent& a, const DamageEvent& b) { return a.target < b.target; });
+    q.eventCount = (int)q.events.size();
+    q.targetCount = 0;
+    q.deaths.clear();
+}
+
+// Walks the sorted events one target at a time, apply(first, last) gets all events of a target.
+template <typename F>
+static void forEachTarget(DamageQueue& q, F&& apply) {
+    size_t n = q.events.size();
+    for (size_t i = 0; i < n;) {
+        size_t j = i + 1;
+        while (j < n && q.events[j].target == q.events[i].target) ++j;
+        apply(&q.events[i], &q.events[j - 1] + 1);
+        q.targetCount++;
+        i = j;
+    }
+    q.events.clear();
+}
+
+// per event feedback; area hits on one mob are summed into a single number
+static void hitFeedback(const CombatFx& fx, const DamageEvent* first, const DamageEvent* last,
+                        const std::vector<Bullet>& bullets, const SDL_FRect& r, SDL_Color color) {
+    int area = 0;
+    for (const DamageEvent* e = first; e != last; ++e) {
+        if (e->source == DAMAGE_BULLET) fxBulletHit(fx, bullets[e->attacker], r, color, e->amount);
+        else area += e->amount;
+    }
+    if (area) fxAreaHit(fx, r, area);
+}
+
+void resolveDamage(DamageQueue& q, std::vector<Mob>& mobs, const std::vector<Bullet>& bullets, const CombatFx& fx) {
+    mergeAndSort(q);
+    forEachTarget(q, [&](const DamageEvent* first, const DamageEvent* last) {
+        Mob& m = mobs[first->target];
+        if (!m.alive) return;
+        int total = 0;
+        for (const DamageEvent* e = first; e != last; ++e) total += e->amount;
+        m.hp -= total;
+        hitFeedback(fx, first, last, bullets, m.rect, m.color);
+        if (m.hp <= 0) {
+            m.alive = false;
+            q.deaths.push_back({ m.rect, m.color, m.type, (last - 1)->source });
+        }
+    });
+}
+
+void resolveDamageCompact(DamageQueue& q, std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                          const std::vector<Bullet>& bullets, const CombatFx& fx) {
+    mergeAndSort(q);
+    forEachTarget(q, [&](const DamageEvent* first, const DamageEvent* last) {
+        CompactMob& m = mobs[first->target];
+        if (!(m.flags & COMPACT_MOB_ALIVE)) return;
+        const CompactArchetype& a = table[m.archetype];
+        SDL_FRect r{ fromFixed(m.x), fromFixed(m.y), a.size, a.size };
+        int total = 0;
+        for (const DamageEvent* e = first; e != last; ++e) total += e->amount;
+        m.hp = (Sint16)std::max(-32768, m.hp - total);
+        hitFeedback(fx, first, last, bullets, r, a.color);
+        if (m.hp <= 0) {
+            m.flags &= (Uint8)~COMPACT_MOB_ALIVE;
+            q.deaths.push_back({ r, a.color, a.type, (last - 1)->source });
+        }
+    });
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "combat_fx.h"
+#include "mob_compact.h"
+
+#include <vector>
+
+enum DamageSource : Uint8 {
+    DAMAGE_BULLET = 0, // attacker = bullet index
+    DAMAGE_AREA,       // explosions, melee
+};
+
+struct DamageEvent {
+    Uint32 target; // index into the mob array
+    Uint32 attacker;
+    Sint32 amount;
+    Uint8 source;
+};
+
+// what downstream systems (particles, drops, score) get for every kill
+struct DeathEvent {
+    SDL_FRect rect;
+    SDL_Color color;
+    Uint8 type;   // index in the MobArchetype table
+    Uint8 source; // source of the killing blow
+};
+
+// Detection passes only emit events, resolution applies them once per frame. Parallel
+// producers write to their own chunk buffer (one per parallelFor chunk, merged in chunk
+// order, so the result does not depend on the thread count); serial producers push directly.
+struct DamageQueue {
+    std::vector<std::vector<DamageEvent>> chunks;
+    std::vector<DamageEvent> events;
+    std::vector<DeathEvent> deaths; // filled by the last resolve
+
+    // stats of the last resolve
+    int eventCount = 0;
+    int targetCount = 0;
+
+    // scratch
+    std::vector<Uint32> found;
+};
+
+// sizes/clears the chunk buffers before a parallel producer runs
+void damageBeginChunks(DamageQueue& q, int chunkCount);
+
+static inline void pushDamage(DamageQueue& q, Uint32 target, Uint32 attacker, int amount, Uint8 source) {
+    q.events.push_back({ target, attacker, amount, source });
+}
+
+// Merges the chunk buffers, sorts by target, applies the summed damage per mob and fills
+// q.deaths. Hit feedback (sparks, numbers) is emitted here, death feedback is left to the
+// consumers of q.deaths. Events against mobs that are already dead are dropped.
+void resolveDamage(DamageQueue& q, std::vector<Mob>& mobs, const std::vector<Bullet>& bullets,
+                   const CombatFx& fx = CombatFx());
+void resolveDamageCompact(DamageQueue& q, std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                          const std::vector<Bullet>& bullets, const CombatFx& fx = CombatFx());
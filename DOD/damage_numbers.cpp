@@ -0,0 +1,115 @@
+#include "damage_numbers.h"
+
+#include <algorithm>
+
+void initDamageNumbers(DamageNumbers& dn, int capacity) {
+    dn.capacity = capacity;
+    dn.x.resize(capacity);
+    dn.y.resize(capacity);
+    dn.age.resize(capacity);
+    dn.value.resize(capacity);
+    clearDamageNumbers(dn);
+}
+
+void clearDamageNumbers(DamageNumbers& dn) {
+    dn.count = 0;
+}
+
+void addDamageNumber(DamageNumbers& dn, float x, float y, int value) {
+    if (dn.capacity == 0) return;
+    bool full = dn.count == dn.capacity;
+    int best = -1;
+    float bestD2 = full ? 1e30f : dn.mergeRadius * dn.mergeRadius;
+    for (int i = 0; i < dn.count; ++i) {
+        if (!full && dn.age[i] > dn.mergeAge) continue;
+        float dx = dn.x[i] - x, dy = dn.y[i] - y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 < bestD2) {
+            bestD2 = d2;
+            best = i;
+        }
+    }
+
+    if (best >= 0) {
+        dn.value[best] += value;
+        dn.age[best] = 0.0f; // pop again
+        dn.mergedThisFrame++;
+        return;
+    }
+    int i = dn.count++;
+    dn.x[i] = x;
+    dn.y[i] = y;
+    dn.age[i] = 0.0f;
+    dn.value[i] = value;
+}
+
+void updateDamageNumbers(DamageNumbers& dn, float dt) {
+    for (int i = 0; i < dn.count;) {
+        dn.age[i] += dt;
+        dn.y[i] -= dn.rise * dt;
+        if (dn.age[i] < dn.life) { ++i; continue; }
+        // swap-remove, order does not matter
+        int last = --dn.count;
+        dn.x[i] = dn.x[last];
+        dn.y[i] = dn.y[last];
+        dn.age[i] = dn.age[last];
+        dn.value[i] = dn.value[last];
+    }
+    dn.mergedLastFrame = dn.mergedThisFrame;
+    dn.mergedThisFrame = 0;
+}
+
+static void refreshDigitCache(DamageNumbers& dn) {
+    ImFontBaked* baked = ImGui::GetFont()->GetFontBaked(dn.fontSize);
+    for (int d = 0; d < 10; ++d) {
+        const ImFontGlyph* g = baked->FindGlyph((ImWchar)('0' + d));
+        dn.digits[d] = { g->X0, g->Y0, g->X1, g->Y1, g->U0, g->V0, g->U1, g->V1, g->AdvanceX };
+    }
+}
+
+// digits of v, most significant first; returns the count
+static int splitDigits(int v, unsigned char out[12]) {
+    unsigned char tmp[12];
+    int n = 0;
+    unsigned u = (unsigned)std::max(v, 0);
+    do { tmp[n++] = (unsigned char)(u % 10); u /= 10; } while (u && n < 12);
+    for (int k = 0; k < n; ++k) out[k] = tmp[n - 1 - k];
+    return n;
+}
+
+void drawDamageNumbers(DamageNumbers& dn, ImDrawList* dl, ImVec2 origin) {
+    dn.quadsLastFrame = 0;
+    if (dn.count == 0) return;
+    refreshDigitCache(dn);
+
+    int glyphs = 0;
+    unsigned char digits[12];
+    for (int i = 0; i < dn.count; ++i) glyphs += splitDigits(dn.value[i], digits);
+    // shadow + glyph per digit, the draw list texture is already the font atlas
+    int quads = glyphs * 2;
+    dl->PrimReserve(quads * 6, quads * 4);
+
+    for (int i = 0; i < dn.count; ++i) {
+        int n = splitDigits(dn.value[i], digits);
+        float t = dn.age[i] / dn.life;
+        float scale = 1.0f + 0.6f * std::max(0.0f, 1.0f - dn.age[i] * 10.0f); // short pop on hit/merge
+        float alpha = 1.0f - t * t;
+        ImU32 col = ImGui::GetColorU32(ImVec4(1.0f, 0.92f, 0.45f, alpha));
+        ImU32 shadow = ImGui::GetColorU32(ImVec4(0.0f, 0.0f, 0.0f, alpha * 0.8f));
+
+        float width = 0.0f;
+        for (int k = 0; k < n; ++k) width += dn.digits[digits[k]].advance;
+        float penX = dn.x[i] - origin.x - width * scale * 0.5f;
+        float penY = dn.y[i] - origin.y - dn.fontSize * scale;
+        for (int k = 0; k < n; ++k) {
+            const DigitQuad& q = dn.digits[digits[k]];
+            ImVec2 a(penX + q.x0 * scale, penY + q.y0 * scale);
+            ImVec2 b(penX + q.x1 * scale, penY + q.y1 * scale);
+            dl->PrimRectUV(ImVec2(a.x + 1.0f, a.y + 1.0f), ImVec2(b.x + 1.0f, b.y + 1.0f),
+                           ImVec2(q.u0, q.v0), ImVec2(q.u1, q.v1), shadow);
+            dl->PrimRectUV(a, b, ImVec2(q.u0, q.v0), ImVec2(q.u1, q.v1), col);
+            penX += q.advance * scale;
+        }
+    }
+    dn.quadsLastFrame = quads;
+}
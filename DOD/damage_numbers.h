@@ -0,0 +1,47 @@
+#pragma once
+
+#include "imgui.h"
+
+#include <vector>
+
+// Floating damage numbers. A fixed pool in structure-of-arrays form; every frame all of them
+// go into the background ImDrawList in one pass: one PrimReserve for the whole batch, then
+// quads copied from a small digit cache (offsets + UVs of '0'-'9' in the font atlas) instead
+// of one text layout per number. A hit close to a recent number adds to it, and a full pool
+// merges into the nearest number, so heavy fire cannot grow the count.
+struct DigitQuad {
+    float x0, y0, x1, y1; // relative to the pen position
+    float u0, v0, u1, v1;
+    float advance;
+};
+
+struct DamageNumbers {
+    int capacity = 0;
+    int count = 0;
+    std::vector<float> x, y; // center bottom of the number
+    std::vector<float> age;
+    std::vector<int> value;
+
+    float life = 0.8f;
+    float rise = 45.0f;        // px/s
+    float mergeRadius = 28.0f;
+    float mergeAge = 0.3f;     // only fresh numbers take merges, older ones fade undisturbed
+    float fontSize = 18.0f;
+
+    // refreshed every draw, the 1.92 font atlas may repack and move glyphs
+    DigitQuad digits[10];
+
+    // stats
+    int mergedLastFrame = 0;
+    int mergedThisFrame = 0;
+    int quadsLastFrame = 0;
+};
+
+void initDamageNumbers(DamageNumbers& dn, int capacity);
+void clearDamageNumbers(DamageNumbers& dn);
+
+void addDamageNumber(DamageNumbers& dn, float x, float y, int value);
+void updateDamageNumbers(DamageNumbers& dn, float dt);
+
+// between ImGui::NewFrame and ImGui::Render; positions are world space, origin is the camera
+void drawDamageNumbers(DamageNumbers& dn, ImDrawList* dl, ImVec2 origin = ImVec2(0.0f, 0.0f));
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cmath>
+
+struct Vec2 { float x, y; };
+
+struct Entity {
+    SDL_FRect rect;
+    SDL_Color color;
+    Vec2 velocity;
+    bool alive = true;
+};
+
+struct Mob : public Entity {
+    int hp = 10;
+    int dmg = 5;
+    float speed = 80.0f;
+    Uint8 type = 0; // index in the MobArchetype table
+    Uint8 lodTier = 0;
+    Uint8 lodBucket = 0; // round-robin slot for reduced-rate tiers
+};
+
+enum BulletFlags : Uint8 {
+    BULLET_HOMING = 1 << 0,    // turns towards the nearest mob
+    BULLET_EXPLOSIVE = 1 << 1, // area damage where it hits
+};
+
+// Limits of the pierce/ricochet sliders, a bullet lands at most pierce + bounces + 1 hits.
+static const int BULLET_MAX_PIERCE = 10;
+static const int BULLET_MAX_BOUNCES = 10;
+
+// Mobs a bullet already damaged, so a piercing/ricocheting bullet never hits the same mob
+// twice. Handles are indices into the mob array, remapped when the array is compacted.
+// Sized for every hit a bullet can land, so no entry is ever dropped.
+static const int BULLET_HIT_SLOTS = BULLET_MAX_PIERCE + BULLET_MAX_BOUNCES + 1;
+
+struct BulletHits {
+    Uint32 mob[BULLET_HIT_SLOTS];
+    Uint8 count = 0;
+};
+
+static inline bool bulletHitsContains(const BulletHits& h, Uint32 mob) {
+    for (int i = 0; i < h.count; ++i) {
+        if (h.mob[i] == mob) return true;
+    }
+    return false;
+}
+
+static inline void bulletHitsAdd(BulletHits& h, Uint32 mob) {
+    if (h.count < BULLET_HIT_SLOTS) h.mob[h.count++] = mob;
+}
+
+struct Bullet : public Entity {
+    Uint8 flags = 0;
+    Uint8 pierce = 0;  // mobs it can still pass through
+    Uint8 bounces = 0; // ricochets left once pierce is spent
+    BulletHits hits;
+};
+
+struct Player {
+    SDL_FRect rect;
+    SDL_Color color;
+    float speed = 300.0f;
+    int hp = 100;
+    int dmg = 4;
+};
+
+// helper: normalize vector
+static inline Vec2 normalize(const Vec2& v) {
+    float len = std::sqrt(v.x * v.x + v.y * v.y);
+    if (len <= 0.0001f) return { 0,0 };
+    return { v.x / len, v.y / len };
+}
+
+static inline bool aabb(const SDL_FRect& a, const SDL_FRect& b) {
+    return (a.x < b.x + b.w &&
+        a.x + a.w > b.x &&
+        a.y < b.y + b.h &&
+        a.y + a.h > b.y);
+}
@@ -0,0 +1,113 @@
+#include "flow_field.h"
+
+#include <algorithm>
+#include <cmath>
+
+void initFlowField(FlowField& f, float worldW, float worldH, float cellSize, const Obstacles& o) {
+    f.cellSize = cellSize;
+    f.cols = std::max(1, (int)std::ceil(worldW / cellSize));
+    f.rows = std::max(1, (int)std::ceil(worldH / cellSize));
+    size_t cells = (size_t)f.cols * f.rows;
+    f.blocked.assign(cells, 0);
+    f.dist.assign(cells, FLOW_UNREACHED);
+    f.dir.assign(cells, FLOW_DIRECT);
+    f.targetCell = -1;
+
+    // any cell a wall touches is blocked, mobs are pushed out of the rest by the BVH
+    float inv = 1.0f / cellSize;
+    for (const SDL_FRect& r : o.rects) {
+        int x0 = std::max(0, (int)std::floor(r.x * inv)), x1 = std::min(f.cols - 1, (int)std::ceil((r.x + r.w) * inv) - 1);
+        int y0 = std::max(0, (int)std::floor(r.y * inv)), y1 = std::min(f.rows - 1, (int)std::ceil((r.y + r.h) * inv) - 1);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) f.blocked[y * f.cols + x] = 1;
+        }
+    }
+    f.nearWall.assign(cells, 0);
+    for (int y = 0; y < f.rows; ++y) {
+        for (int x = 0; x < f.cols; ++x) {
+            if (!f.blocked[y * f.cols + x]) continue;
+            for (int d = 0; d < 8; ++d) {
+                int nx = x + FLOW_DX[d], ny = y + FLOW_DY[d];
+                if (nx >= 0 && ny >= 0 && nx < f.cols && ny < f.rows) f.nearWall[ny * f.cols + nx] = 1;
+            }
+        }
+    }
+}
+
+// 0-7 step closest to the straight line from (x, y) to (tx, ty)
+static int straightStep(int x, int y, int tx, int ty) {
+    int dx = tx - x, dy = ty - y;
+    // a diagonal when the minor axis is at least half the major one (within 22.5 deg)
+    int sx = dx > 0 ? 1 : dx < 0 ? -1 : 0, sy = dy > 0 ? 1 : dy < 0 ? -1 : 0;
+    if (2 * std::abs(dy) < std::abs(dx)) sy = 0;
+    else if (2 * std::abs(dx) < std::abs(dy)) sx = 0;
+    for (int d = 0; d < 8; ++d) {
+        if (FLOW_DX[d] == sx && FLOW_DY[d] == sy) return d;
+    }
+    return -1;
+}
+
+bool updateFlowField(FlowField& f, Vec2 target) {
+    int t = flowCellAt(f, target.x, target.y);
+    if (t == f.targetCell) return false;
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    f.targetCell = t;
+
+    // BFS over the 4 neighbours, the target cell is seeded even if a wall touches it
+    std::fill(f.dist.begin(), f.dist.end(), FLOW_UNREACHED);
+    f.queue.clear();
+    f.queue.push_back((Uint32)t);
+    f.dist[t] = 0;
+    for (size_t head = 0; head < f.queue.size(); ++head) {
+        Uint32 c = f.queue[head];
+        int x = (int)(c % f.cols), y = (int)(c / f.cols);
+        Uint16 next = (Uint16)std::min(f.dist[c] + 1, FLOW_UNREACHED - 1);
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + FLOW_DX[d], ny = y + FLOW_DY[d];
+            if (nx < 0 || ny < 0 || nx >= f.cols || ny >= f.rows) continue;
+            Uint32 n = (Uint32)(ny * f.cols + nx);
+            if (f.blocked[n] || f.dist[n] != FLOW_UNREACHED) continue;
+            f.dist[n] = next;
+            f.queue.push_back(n);
+        }
+    }
+    f.cellsReached = (int)f.queue.size();
+
+    // Downhill step per cell. Open cells (no wall next to them) whose straight step towards the
+    // target is already downhill stay FLOW_DIRECT, so open ground does not get the 45 degree
+    // staircase of the grid metric.
+    int tx = t % f.cols, ty = t / f.cols;
+    for (int y = 0; y < f.rows; ++y) {
+        for (int x = 0; x < f.cols; ++x) {
+            int c = y * f.cols + x;
+            int own = f.dist[c];
+            Uint8 best = FLOW_DIRECT;
+            // unreached open cells are walled in, nothing to follow there
+            if (own > 1 && (own != FLOW_UNREACHED || f.blocked[c])) {
+                int bestDist = own;
+                int straight = f.nearWall[c] ? -1 : straightStep(x, y, tx, ty);
+                for (int d = 0; d < 8; ++d) {
+                    int nx = x + FLOW_DX[d], ny = y + FLOW_DY[d];
+                    if (nx < 0 || ny < 0 || nx >= f.cols || ny >= f.rows) continue;
+                    // no corner cutting, unless this cell is itself inside a wall
+                    if (d >= 4 && !f.blocked[c] &&
+                        (f.blocked[y * f.cols + nx] || f.blocked[ny * f.cols + x])) continue;
+                    int nd = f.dist[ny * f.cols + nx];
+                    if (d == straight && nd < own) {
+                        best = FLOW_DIRECT;
+                        break;
+                    }
+                    if (nd < bestDist) {
+                        bestDist = nd;
+                        best = (Uint8)d;
+                    }
+                }
+            }
+            f.dir[c] = best;
+        }
+    }
+
+    f.rebuilds++;
+    f.buildMs = (float)((SDL_GetPerformanceCounter() - t0) * 1000.0 / SDL_GetPerformanceFrequency());
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "entities.h"
+#include "obstacles.h"
+
+#include <vector>
+
+static const Uint16 FLOW_UNREACHED = 0xFFFF;
+static const Uint8 FLOW_DIRECT = 0xFF; // no detour needed (or none possible): head straight for the target
+
+// unit steps, 0-3 orthogonal, 4-7 diagonal
+static const int FLOW_DX[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+static const int FLOW_DY[8] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+static const Vec2 FLOW_DIRS[8] = {
+    { 1.0f, 0.0f }, { -1.0f, 0.0f }, { 0.0f, 1.0f }, { 0.0f, -1.0f },
+    { 0.7071f, 0.7071f }, { -0.7071f, 0.7071f }, { 0.7071f, -0.7071f }, { -0.7071f, -0.7071f },
+};
+
+// Grid over the world with the walls rasterized once. When the target moves to another cell a
+// BFS from it fills the step distance of every reachable cell, then each cell stores the
+// neighbour step that goes downhill. Mobs read one byte per update instead of pathfinding.
+struct FlowField {
+    float cellSize = 64.0f;
+    int cols = 0, rows = 0;
+    std::vector<Uint8> blocked;
+    std::vector<Uint8> nearWall; // a blocked cell among the 8 neighbours
+    std::vector<Uint16> dist;
+    std::vector<Uint8> dir;
+    int targetCell = -1;
+    std::vector<Uint32> queue;
+
+    // stats of the last rebuild
+    int rebuilds = 0;
+    int cellsReached = 0;
+    float buildMs = 0.0f;
+};
+
+void initFlowField(FlowField& f, float worldW, float worldH, float cellSize, const Obstacles& o);
+
+static inline int flowCellAt(const FlowField& f, float x, float y) {
+    int cx = (int)(x / f.cellSize), cy = (int)(y / f.cellSize);
+    cx = cx < 0 ? 0 : cx >= f.cols ? f.cols - 1 : cx;
+    cy = cy < 0 ? 0 : cy >= f.rows ? f.rows - 1 : cy;
+    return cy * f.cols + cx;
+}
+
+// rebuilds only when target is in a different cell than last time, returns true if it did
+bool updateFlowField(FlowField& f, Vec2 target);
+
+// Step direction at pos, zero when the mob should head straight for the target. Orthogonal
+// steps also pull towards the middle of the cell so bodies do not snag on wall corners.
+static inline Vec2 flowDirection(const FlowField& f, float x, float y) {
+    if (f.targetCell < 0) return { 0.0f, 0.0f };
+    int c = flowCellAt(f, x, y);
+    Uint8 d = f.dir[c];
+    if (d == FLOW_DIRECT) return { 0.0f, 0.0f };
+    Vec2 v = FLOW_DIRS[d];
+    if (d >= 4) return v;
+    if (v.x == 0.0f) v.x = ((c % f.cols + 0.5f) * f.cellSize - x) / f.cellSize;
+    else v.y = ((c / f.cols + 0.5f) * f.cellSize - y) / f.cellSize;
+    return normalize(v);
+}
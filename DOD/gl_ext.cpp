@@ -0,0 +1,104 @@
+#include "gl_ext.h"
+
+#include <cstdio>
+
+GLExt glx;
+
+template <typename T>
+static bool loadProc(T& fn, const char* name) {
+    fn = (T)SDL_GL_GetProcAddress(name);
+    if (!fn) printf("GL function %s not available\n", name);
+    return fn != nullptr;
+}
+
+bool loadGLExt() {
+    if (glx.loaded) return true;
+    bool ok = true;
+    ok &= loadProc(glx.GenBuffers, "glGenBuffers");
+    ok &= loadProc(glx.DeleteBuffers, "glDeleteBuffers");
+    ok &= loadProc(glx.BindBuffer, "glBindBuffer");
+    ok &= loadProc(glx.BufferData, "glBufferData");
+    ok &= loadProc(glx.BufferSubData, "glBufferSubData");
+    ok &= loadProc(glx.GenVertexArrays, "glGenVertexArrays");
+    ok &= loadProc(glx.DeleteVertexArrays, "glDeleteVertexArrays");
+    ok &= loadProc(glx.BindVertexArray, "glBindVertexArray");
+    ok &= loadProc(glx.EnableVertexAttribArray, "glEnableVertexAttribArray");
+    ok &= loadProc(glx.VertexAttribPointer, "glVertexAttribPointer");
+    ok &= loadProc(glx.VertexAttribDivisor, "glVertexAttribDivisor");
+    ok &= loadProc(glx.DrawArraysInstanced, "glDrawArraysInstanced");
+    ok &= loadProc(glx.CreateShader, "glCreateShader");
+    ok &= loadProc(glx.DeleteShader, "glDeleteShader");
+    ok &= loadProc(glx.ShaderSource, "glShaderSource");
+    ok &= loadProc(glx.CompileShader, "glCompileShader");
+    ok &= loadProc(glx.GetShaderiv, "glGetShaderiv");
+    ok &= loadProc(glx.GetShaderInfoLog, "glGetShaderInfoLog");
+    ok &= loadProc(glx.CreateProgram, "glCreateProgram");
+    ok &= loadProc(glx.DeleteProgram, "glDeleteProgram");
+    ok &= loadProc(glx.AttachShader, "glAttachShader");
+    ok &= loadProc(glx.BindAttribLocation, "glBindAttribLocation");
+    ok &= loadProc(glx.LinkProgram, "glLinkProgram");
+    ok &= loadProc(glx.GetProgramiv, "glGetProgramiv");
+    ok &= loadProc(glx.GetProgramInfoLog, "glGetProgramInfoLog");
+    ok &= loadProc(glx.UseProgram, "glUseProgram");
+    ok &= loadProc(glx.GetUniformLocation, "glGetUniformLocation");
+    ok &= loadProc(glx.Uniform2f, "glUniform2f");
+    ok &= loadProc(glx.Uniform4fv, "glUniform4fv");
+    glx.loaded = ok;
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major * 10 + minor >= 44 || SDL_GL_ExtensionSupported("GL_ARB_buffer_storage")) {
+        glx.hasBufferStorage = true;
+        glx.hasBufferStorage &= loadProc(glx.BufferStorage, "glBufferStorage");
+        glx.hasBufferStorage &= loadProc(glx.MapBufferRange, "glMapBufferRange");
+        glx.hasBufferStorage &= loadProc(glx.UnmapBuffer, "glUnmapBuffer");
+        glx.hasBufferStorage &= loadProc(glx.FenceSync, "glFenceSync");
+        glx.hasBufferStorage &= loadProc(glx.ClientWaitSync, "glClientWaitSync");
+        glx.hasBufferStorage &= loadProc(glx.DeleteSync, "glDeleteSync");
+    }
+    return ok;
+}
+
+static GLuint compileShader(GLenum type, const char* src) {
+    GLuint sh = glx.CreateShader(type);
+    glx.ShaderSource(sh, 1, &src, nullptr);
+    glx.CompileShader(sh);
+    GLint ok = 0;
+    glx.GetShaderiv(sh, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glx.GetShaderInfoLog(sh, sizeof(log), nullptr, log);
+        printf("Shader compile failed: %s\n", log);
+        glx.DeleteShader(sh);
+        return 0;
+    }
+    return sh;
+}
+
+GLuint buildGLProgram(const char* vs, const char* fs, const char* const* attribs, int attribCount) {
+    GLuint v = compileShader(GL_VERTEX_SHADER, vs);
+    GLuint f = compileShader(GL_FRAGMENT_SHADER, fs);
+    if (!v || !f) {
+        if (v) glx.DeleteShader(v);
+        if (f) glx.DeleteShader(f);
+        return 0;
+    }
+    GLuint prog = glx.CreateProgram();
+    glx.AttachShader(prog, v);
+    glx.AttachShader(prog, f);
+    for (int i = 0; i < attribCount; ++i) glx.BindAttribLocation(prog, (GLuint)i, attribs[i]);
+    glx.LinkProgram(prog);
+    glx.DeleteShader(v);
+    glx.DeleteShader(f);
+    GLint ok = 0;
+    glx.GetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glx.GetProgramInfoLog(prog, sizeof(log), nullptr, log);
+        printf("Program link failed: %s\n", log);
+        glx.DeleteProgram(prog);
+        return 0;
+    }
+    return prog;
+}
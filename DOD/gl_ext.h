@@ -0,0 +1,56 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_opengl.h>
+
+// GL entry points past 1.1, loaded through SDL_GL_GetProcAddress. One table per process;
+// the pointers are the same for every context of the same driver.
+struct GLExt {
+    bool loaded = false;
+    PFNGLGENBUFFERSPROC GenBuffers;
+    PFNGLDELETEBUFFERSPROC DeleteBuffers;
+    PFNGLBINDBUFFERPROC BindBuffer;
+    PFNGLBUFFERDATAPROC BufferData;
+    PFNGLBUFFERSUBDATAPROC BufferSubData;
+    PFNGLGENVERTEXARRAYSPROC GenVertexArrays;
+    PFNGLDELETEVERTEXARRAYSPROC DeleteVertexArrays;
+    PFNGLBINDVERTEXARRAYPROC BindVertexArray;
+    PFNGLENABLEVERTEXATTRIBARRAYPROC EnableVertexAttribArray;
+    PFNGLVERTEXATTRIBPOINTERPROC VertexAttribPointer;
+    PFNGLVERTEXATTRIBDIVISORPROC VertexAttribDivisor;
+    PFNGLDRAWARRAYSINSTANCEDPROC DrawArraysInstanced;
+    PFNGLCREATESHADERPROC CreateShader;
+    PFNGLDELETESHADERPROC DeleteShader;
+    PFNGLSHADERSOURCEPROC ShaderSource;
+    PFNGLCOMPILESHADERPROC CompileShader;
+    PFNGLGETSHADERIVPROC GetShaderiv;
+    PFNGLGETSHADERINFOLOGPROC GetShaderInfoLog;
+    PFNGLCREATEPROGRAMPROC CreateProgram;
+    PFNGLDELETEPROGRAMPROC DeleteProgram;
+    PFNGLATTACHSHADERPROC AttachShader;
+    PFNGLBINDATTRIBLOCATIONPROC BindAttribLocation;
+    PFNGLLINKPROGRAMPROC LinkProgram;
+    PFNGLGETPROGRAMIVPROC GetProgramiv;
+    PFNGLGETPROGRAMINFOLOGPROC GetProgramInfoLog;
+    PFNGLUSEPROGRAMPROC UseProgram;
+    PFNGLGETUNIFORMLOCATIONPROC GetUniformLocation;
+    PFNGLUNIFORM2FPROC Uniform2f;
+    PFNGLUNIFORM4FVPROC Uniform4fv;
+
+    // optional, GL 4.4 / ARB_buffer_storage (persistent mapping)
+    bool hasBufferStorage = false;
+    PFNGLBUFFERSTORAGEPROC BufferStorage;
+    PFNGLMAPBUFFERRANGEPROC MapBufferRange;
+    PFNGLUNMAPBUFFERPROC UnmapBuffer;
+    PFNGLFENCESYNCPROC FenceSync;
+    PFNGLCLIENTWAITSYNCPROC ClientWaitSync;
+    PFNGLDELETESYNCPROC DeleteSync;
+};
+
+extern GLExt glx;
+
+// needs a current context; false if anything required is missing (GL < 3.3)
+bool loadGLExt();
+
+// compiles and links a vertex + fragment program, attribute locations bound in order
+GLuint buildGLProgram(const char* vs, const char* fs, const char* const* attribs, int attribCount);
@@ -0,0 +1,71 @@
+#include "gl_ring.h"
+
+#include <cstdio>
+
+bool glRingCreate(GLRingBuffer& ring, size_t segmentSize) {
+    if (!glx.hasBufferStorage) return false;
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const size_t total = segmentSize * GL_RING_SEGMENTS;
+
+    glx.GenBuffers(1, &ring.buffer);
+    glx.BindBuffer(GL_ARRAY_BUFFER, ring.buffer);
+    glx.BufferStorage(GL_ARRAY_BUFFER, (GLsizeiptr)total, nullptr, flags);
+    ring.mapped = (Uint8*)glx.MapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)total, flags);
+    glx.BindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!ring.mapped) {
+        printf("Persistent buffer mapping failed (GL error 0x%x)\n", glGetError());
+        glx.DeleteBuffers(1, &ring.buffer);
+        ring.buffer = 0;
+        return false;
+    }
+    ring.segmentSize = segmentSize;
+    ring.segment = 0;
+    ring.used = 0;
+    return true;
+}
+
+void glRingDestroy(GLRingBuffer& ring) {
+    for (GLsync& f : ring.fences) {
+        if (f) glx.DeleteSync(f);
+        f = nullptr;
+    }
+    if (ring.buffer) {
+        glx.BindBuffer(GL_ARRAY_BUFFER, ring.buffer);
+        glx.UnmapBuffer(GL_ARRAY_BUFFER);
+        glx.BindBuffer(GL_ARRAY_BUFFER, 0);
+        glx.DeleteBuffers(1, &ring.buffer);
+    }
+    ring.buffer = 0;
+    ring.mapped = nullptr;
+}
+
+void glRingBeginFrame(GLRingBuffer& ring) {
+    ring.segment = (ring.segment + 1) % GL_RING_SEGMENTS;
+    ring.used = 0;
+    GLsync& fence = ring.fences[ring.segment];
+    if (!fence) return;
+
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    // 1 s timeout: a lost fence should stall a frame, not hang the game
+    glx.ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+    ring.waitMs += (SDL_GetPerformanceCounter() - t0) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    glx.DeleteSync(fence);
+    fence = nullptr;
+}
+
+void* glRingAlloc(GLRingBuffer& ring, size_t size, size_t align, size_t* outOffset) {
+    size_t start = (ring.used + align - 1) / align * align;
+    if (!ring.mapped || start + size > ring.segmentSize) {
+        ring.failedAllocs++;
+        return nullptr;
+    }
+    ring.used = start + size;
+    if (ring.used > ring.peakUsed) ring.peakUsed = ring.used;
+    *outOffset = (size_t)ring.segment * ring.segmentSize + start;
+    return ring.mapped + *outOffset;
+}
+
+void glRingEndFrame(GLRingBuffer& ring) {
+    if (!ring.mapped) return;
+    ring.fences[ring.segment] = glx.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
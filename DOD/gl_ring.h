@@ -0,0 +1,34 @@
+#pragma once
+
+#include "gl_ext.h"
+
+// Persistent-mapped streaming buffer (glBufferStorage, GL 4.4 / ARB_buffer_storage) split in
+// GL_RING_SEGMENTS per-frame segments. A frame only writes its own segment and fences it at
+// the end; before reusing a segment the CPU waits on that fence, so data the GPU may still be
+// reading is never overwritten. One ring is shared by the rect renderer and ImGui.
+static const int GL_RING_SEGMENTS = 3;
+
+struct GLRingBuffer {
+    GLuint buffer = 0;
+    Uint8* mapped = nullptr;
+    size_t segmentSize = 0;
+    int segment = 0;
+    size_t used = 0; // bytes used in the current segment
+    GLsync fences[GL_RING_SEGMENTS] = {};
+
+    // stats
+    size_t peakUsed = 0;
+    int failedAllocs = 0;  // allocations that did not fit; callers fell back to glBufferData
+    double waitMs = 0.0;   // total time blocked on fences
+};
+
+// needs a current context and loadGLExt(); false when persistent mapping is not supported
+bool glRingCreate(GLRingBuffer& ring, size_t segmentSize);
+void glRingDestroy(GLRingBuffer& ring);
+
+// moves to the next segment, waiting for the GPU if it still uses it
+void glRingBeginFrame(GLRingBuffer& ring);
+// write pointer for `size` bytes at *outOffset in ring.buffer, nullptr if the segment is full
+void* glRingAlloc(GLRingBuffer& ring, size_t size, size_t align, size_t* outOffset);
+// fences everything submitted from the current segment
+void glRingEndFrame(GLRingBuffer& ring);
@@ -0,0 +1,135 @@
+#include "jobs.h"
+
+#include <cstdio>
+#include <vector>
+
+struct JobBatch {
+    JobFn fn;
+    void* user;
+    int count;
+    int grain;
+    int chunks;
+    SDL_AtomicInt nextChunk;
+    SDL_AtomicInt doneChunks;
+    SDL_AtomicInt users; // workers currently holding a pointer to this batch
+    JobBatch* next;
+};
+
+static SDL_Mutex* g_lock = nullptr;
+static SDL_Condition* g_wake = nullptr;
+static JobBatch* g_batches = nullptr;
+static bool g_quit = false;
+static std::vector<SDL_Thread*> g_workers;
+
+// runs chunks until the batch has none left, returns the number executed
+static int runChunks(JobBatch& b) {
+    int ran = 0;
+    while (true) {
+        int chunk = SDL_AddAtomicInt(&b.nextChunk, 1);
+        if (chunk >= b.chunks) break;
+        int begin = chunk * b.grain;
+        int end = SDL_min(begin + b.grain, b.count);
+        b.fn(begin, end, b.user);
+        SDL_AddAtomicInt(&b.doneChunks, 1);
+        ++ran;
+    }
+    return ran;
+}
+
+static void unlinkBatch(JobBatch* b) {
+    for (JobBatch** p = &g_batches; *p; p = &(*p)->next) {
+        if (*p == b) { *p = b->next; return; }
+    }
+}
+
+static int SDLCALL workerMain(void*) {
+    SDL_LockMutex(g_lock);
+    while (true) {
+        while (!g_quit && !g_batches) SDL_WaitCondition(g_wake, g_lock);
+        if (g_quit) break;
+
+        JobBatch* b = g_batches;
+        SDL_AddAtomicInt(&b->users, 1);
+        SDL_UnlockMutex(g_lock);
+
+        runChunks(*b);
+
+        SDL_LockMutex(g_lock);
+        // nothing left to hand out, stop offering it to other workers
+        unlinkBatch(b);
+        SDL_AddAtomicInt(&b->users, -1);
+    }
+    SDL_UnlockMutex(g_lock);
+    return 0;
+}
+
+bool jobsInit(int workers) {
+    if (workers <= 0) workers = SDL_max(0, SDL_GetNumLogicalCPUCores() - 1);
+    g_lock = SDL_CreateMutex();
+    g_wake = SDL_CreateCondition();
+    g_quit = false;
+    for (int i = 0; i < workers; ++i) {
+        SDL_Thread* t = SDL_CreateThread(workerMain, "worker", nullptr);
+        if (!t) {
+            printf("Worker thread create failed: %s\n", SDL_GetError());
+            break;
+        }
+        g_workers.push_back(t);
+    }
+    return !g_workers.empty() || workers == 0;
+}
+
+void jobsShutdown() {
+    if (!g_lock) return;
+    SDL_LockMutex(g_lock);
+    g_quit = true;
+    SDL_BroadcastCondition(g_wake);
+    SDL_UnlockMutex(g_lock);
+    for (SDL_Thread* t : g_workers) SDL_WaitThread(t, nullptr);
+    g_workers.clear();
+    SDL_DestroyCondition(g_wake);
+    SDL_DestroyMutex(g_lock);
+    g_wake = nullptr;
+    g_lock = nullptr;
+}
+
+int jobsWorkerCount() {
+    return (int)g_workers.size();
+}
+
+void parallelFor(int count, int grain, JobFn fn, void* user) {
+    if (count <= 0) return;
+    grain = SDL_max(1, grain);
+    int chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || g_workers.empty()) {
+        fn(0, count, user);
+        return;
+    }
+
+    JobBatch b;
+    b.fn = fn;
+    b.user = user;
+    b.count = count;
+    b.grain = grain;
+    b.chunks = chunks;
+    SDL_SetAtomicInt(&b.nextChunk, 0);
+    SDL_SetAtomicInt(&b.doneChunks, 0);
+    SDL_SetAtomicInt(&b.users, 0);
+
+    SDL_LockMutex(g_lock);
+    b.next = g_batches;
+    g_batches = &b;
+    SDL_BroadcastCondition(g_wake);
+    SDL_UnlockMutex(g_lock);
+
+    runChunks(b);
+
+    // chunks taken by workers may still be running
+    while (SDL_GetAtomicInt(&b.doneChunks) < chunks) SDL_CPUPauseInstruction();
+
+    SDL_LockMutex(g_lock);
+    unlinkBatch(&b);
+    SDL_UnlockMutex(g_lock);
+    // b lives on this stack frame, wait for workers that still hold a pointer to it
+    while (SDL_GetAtomicInt(&b.users) > 0) SDL_CPUPauseInstruction();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <type_traits>
+
+// Small worker pool for data-parallel loops. Several threads may call parallelFor at the
+// same time (e.g. simulation and render thread); the caller always helps with its own batch.
+
+// workers <= 0 picks (logical cores - 1)
+bool jobsInit(int workers = 0);
+void jobsShutdown();
+int jobsWorkerCount();
+
+typedef void (*JobFn)(int begin, int end, void* user);
+
+// Runs fn over [0, count) in chunks of `grain` items and returns when all chunks are done.
+void parallelFor(int count, int grain, JobFn fn, void* user);
+
+template <typename F>
+static void parallelForTrampoline(int begin, int end, void* user) {
+    (*(F*)user)(begin, end);
+}
+
+template <typename F>
+void parallelFor(int count, int grain, F&& body) {
+    typedef typename std::remove_reference<F>::type Body;
+    parallelFor(count, grain, &parallelForTrampoline<Body>, (void*)&body);
+}
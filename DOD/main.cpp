@@ -1,9 +1,34 @@
 ﻿#include <SDL3/SDL.h>
-#include <SDL3/SDL_opengl.h>
 
 #include "imgui.h"
 #include "backends/imgui_impl_sdl3.h"
-#include "backends/imgui_impl_opengl3.h"
+
+#include "entities.h"
+#include "mob_compact.h"
+#include "mob_archetypes.h"
+#include "wave_director.h"
+#include "mob_lod.h"
+#include "cull.h"
+#include "profiler.h"
+#include "render_snapshot.h"
+#include "render_thread.h"
+#include "renderer.h"
+#include "render_gl.h"
+#include "render_soft.h"
+#include "render_sdl.h"
+#include "sprite_atlas.h"
+#include "asset_loader.h"
+#include "combat_fx.h"
+#include "spatial_grid.h"
+#include "area_damage.h"
+#include "bullet_collision.h"
+#include "xp_gems.h"
+#include "buffs.h"
+#include "weapons.h"
+#include "world.h"
+#include "obstacles.h"
+#include "flow_field.h"
+#include "jobs.h"
 
 #include <vector>
 #include <cstdlib>
@@ -12,126 +37,405 @@
 #include <cmath>
 #include <algorithm>
 
-struct Vec2 { float x, y; };
-
-struct Entity {
-    SDL_FRect rect;
-    SDL_Color color;
-    Vec2 velocity;
-    bool alive = true;
-};
-
-struct Mob : public Entity {
-    int hp = 10;
-    int dmg = 5;
-};
-
-struct Player {
-    SDL_FRect rect;
-    SDL_Color color;
-    float speed = 300.0f;
-    int hp = 100;
-	int dmg = 4;
-};
-
-struct Buff_Box {
-    SDL_FRect rect;
-    SDL_Color color;
-    enum class Type { FIRE_RATE, BULLET_SPEED, HEAL, FIRE_MODE, BULLET_DAMAGE } type;
-    bool alive = true;
-};
-
-// helper: normalize vector
-static Vec2 normalize(const Vec2& v) {
-    float len = std::sqrt(v.x * v.x + v.y * v.y);
-    if (len <= 0.0001f) return { 0,0 };
-    return { v.x / len, v.y / len };
-}
-
-void drawRectGL(const SDL_FRect& r, const SDL_Color& c) {
-    glColor4f(c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, c.a / 255.0f);
-    glBegin(GL_QUADS);
-    glVertex2f(r.x, r.y);
-    glVertex2f(r.x + r.w, r.y);
-    glVertex2f(r.x + r.w, r.y + r.h);
-    glVertex2f(r.x, r.y + r.h);
-    glEnd();
-}
-
-bool aabb(const SDL_FRect& a, const SDL_FRect& b) {
-    return (a.x < b.x + b.w &&
-        a.x + a.w > b.x &&
-        a.y < b.y + b.h &&
-        a.y + a.h > b.y);
-}
-
 int main(int argc, char** argv)
 {
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+    // --renderer gl|gl-instanced|sdl[:driver]|soft (default gl), e.g. "--renderer sdl:software"
+    // --gl-ring: gl backends stream through a persistent-mapped ring buffer (GL 4.4+)
+    // --no-render-thread: render on the main thread (debugging / comparison)
+    // --headless: no window, fixed 60 Hz steps rendered by the software rasterizer
+    //   --frames N, --seed S, --ui (draw the debug windows, their timings are not deterministic)
+    //   --dump out.ppm|out.png, --golden ref.ppm [--golden-tolerance T]
+    bool useRenderThread = true;
+    bool headless = false;
+    RendererKind rendererKind = RENDERER_GL;
+    const char* sdlDriver = nullptr;
+    bool glRing = false;
+    bool headlessUi = false;
+    int headlessFrames = 600;
+    unsigned seed = (unsigned)std::time(nullptr);
+    const char* dumpPath = nullptr;
+    const char* goldenPath = nullptr;
+    int goldenTolerance = 2;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (SDL_strcmp(argv[i], "--no-render-thread") == 0) useRenderThread = false;
+        else if (SDL_strcmp(argv[i], "--headless") == 0) headless = true;
+        else if (SDL_strcmp(argv[i], "--gl-ring") == 0) glRing = true;
+        else if (SDL_strcmp(argv[i], "--renderer") == 0 && hasValue) {
+            if (!parseRendererKind(argv[++i], rendererKind, &sdlDriver)) {
+                printf("Unknown renderer '%s' (gl, gl-instanced, sdl[:driver], soft)\n", argv[i]);
+                return -1;
+            }
+        }
+        else if (SDL_strcmp(argv[i], "--ui") == 0) headlessUi = true;
+        else if (SDL_strcmp(argv[i], "--frames") == 0 && hasValue) headlessFrames = SDL_atoi(argv[++i]);
+        else if (SDL_strcmp(argv[i], "--seed") == 0 && hasValue) seed = (unsigned)SDL_atoi(argv[++i]);
+        else if (SDL_strcmp(argv[i], "--dump") == 0 && hasValue) dumpPath = argv[++i];
+        else if (SDL_strcmp(argv[i], "--golden") == 0 && hasValue) goldenPath = argv[++i];
+        else if (SDL_strcmp(argv[i], "--golden-tolerance") == 0 && hasValue) goldenTolerance = SDL_atoi(argv[++i]);
+    }
+    if (headless) {
+        rendererKind = RENDERER_SOFT;
+        useRenderThread = false;
+        if (!gridSelfCheck()) return 1;
+    }
+    const bool useGL = rendererKind == RENDERER_GL || rendererKind == RENDERER_GL_INSTANCED;
+
+    if (!SDL_Init(headless ? 0 : SDL_INIT_VIDEO)) {
         printf("SDL init failed: %s\n", SDL_GetError());
         return -1;
     }
+    jobsInit();
 
     const int WIN_W = 1800;
     const int WIN_H = 1000;
 
-    SDL_Window* window = SDL_CreateWindow("Brotato Wannabe", WIN_W, WIN_H, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
-    if (!window) {
-        printf("CreateWindow failed: %s\n", SDL_GetError());
-        SDL_Quit();
-        return -1;
+    SDL_Window* window = nullptr;
+    SDL_GLContext gl_context = nullptr;
+    if (!headless) {
+        SDL_WindowFlags windowFlags = SDL_WINDOW_RESIZABLE | (useGL ? SDL_WINDOW_OPENGL : 0);
+        window = SDL_CreateWindow("Brotato Wannabe", WIN_W, WIN_H, windowFlags);
+        if (!window) {
+            printf("CreateWindow failed: %s\n", SDL_GetError());
+            SDL_Quit();
+            return -1;
+        }
     }
-
-    SDL_GLContext gl_context = SDL_GL_CreateContext(window);
-    if (!gl_context) {
-        printf("GL context create failed: %s\n", SDL_GetError());
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return -1;
+    if (useGL) {
+        gl_context = SDL_GL_CreateContext(window);
+        if (!gl_context) {
+            printf("GL context create failed: %s\n", SDL_GetError());
+            SDL_DestroyWindow(window);
+            SDL_Quit();
+            return -1;
+        }
+        SDL_GL_MakeCurrent(window, nullptr); // the renderer makes it current where it runs
     }
-    SDL_GL_MakeCurrent(window, gl_context);
-    SDL_GL_SetSwapInterval(1);
+
+    // backend selectat din linia de comanda
+    GLRenderer glRenderer;
+    glRenderer.window = window;
+    glRenderer.context = gl_context;
+    glRenderer.instanced = rendererKind == RENDERER_GL_INSTANCED;
+    glRenderer.useRing = glRing;
+    SDLRenderer sdlRenderer;
+    sdlRenderer.window = window;
+    sdlRenderer.driver = sdlDriver;
+    SoftRenderer softRenderer;
+    softRenderer.window = window;
+    Renderer renderer;
+    if (useGL) renderer = glRendererInterface(glRenderer);
+    else if (rendererKind == RENDERER_SDL) renderer = sdlRendererInterface(sdlRenderer);
+    else renderer = softRendererInterface(softRenderer);
+    if (renderer.mainThreadOnly) useRenderThread = false;
 
     // ImGui setup
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO(); (void)io;
     ImGui::StyleColorsDark();
-    ImGui_ImplSDL3_InitForOpenGL(window, gl_context);
-    ImGui_ImplOpenGL3_Init("#version 130");
+    if (headless) {
+        io.IniFilename = nullptr;
+        io.DisplaySize = ImVec2((float)WIN_W, (float)WIN_H);
+    }
 
-    
-    std::srand((unsigned)std::time(nullptr));
+    // With the render thread the renderer lives there; the simulation only produces snapshots
+    RenderThread renderThread;
+    RenderSnapshot inlineSnapshot;
+    bool rendererOk = useRenderThread ? startRenderThread(renderThread, renderer) : renderer.init(renderer.self);
+    if (!rendererOk) {
+        printf("Renderer %s failed to start\n", renderer.name);
+        if (useRenderThread) stopRenderThread(renderThread);
+        ImGui::DestroyContext();
+        if (gl_context) SDL_GL_DestroyContext(gl_context);
+        if (window) SDL_DestroyWindow(window);
+        jobsShutdown();
+        SDL_Quit();
+        return -1;
+    }
+    printf("Renderer: %s%s\n", renderer.name, useRenderThread ? " (render thread)" : "");
+
+    if (useGL) ImGui_ImplSDL3_InitForOpenGL(window, gl_context);
+    else if (rendererKind == RENDERER_SDL) ImGui_ImplSDL3_InitForSDLRenderer(window, sdlRenderer.renderer);
+    else if (!headless) ImGui_ImplSDL3_InitForOther(window);
+
+    // Asset-urile se citesc pe fire separate, fereastra apare imediat cu o bara de progres
+    AssetLoader assets;
+    const int mobsAsset = assetLoaderAddFile(assets, "data/mobs.txt");
+    const int wavesAsset = assetLoaderAddFile(assets, "data/waves.txt");
+    const int levelAsset = assetLoaderAddFile(assets, "data/level.txt");
+    assetLoaderAddImages(assets, "data/sprites", "*.bmp");
+    assetLoaderStart(assets);
+
+    bool running = true;
+    SDL_Event e;
+    std::vector<Asset*> arrived;
+    while (!assetLoaderDone(assets)) {
+        assetLoaderPoll(assets, arrived);
+        if (headless) {
+            SDL_Delay(1);
+            continue;
+        }
+        while (SDL_PollEvent(&e)) {
+            ImGui_ImplSDL3_ProcessEvent(&e);
+            if (e.type == SDL_EVENT_QUIT || e.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) running = false;
+        }
+
+        ImGui_ImplSDL3_NewFrame();
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(WIN_W * 0.5f, WIN_H * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+        ImGui::Begin("Loading", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse);
+        ImGui::ProgressBar(assetLoaderProgress(assets), ImVec2(320.0f, 0.0f));
+        ImGui::Text("%d/%d assets, %.1f KB", assets.finished, (int)assets.assets.size(), assets.bytesLoaded / 1024.0);
+        if (!arrived.empty()) ImGui::TextDisabled("%s", arrived.back()->path);
+        ImGui::End();
+        ImGui::Render();
+
+        RenderSnapshot& snap = useRenderThread ? renderThreadBackBuffer(renderThread) : inlineSnapshot;
+        snapshotBegin(snap, WIN_W, WIN_H, 0);
+        snap.atlas = nullptr;
+        ImDrawData* drawData = ImGui::GetDrawData();
+        snapshotCopyImGui(snap, drawData, !useRenderThread || imguiTexturesPending(drawData));
+        if (useRenderThread) renderThreadPublish(renderThread);
+        else rendererDrawSnapshot(renderer, inlineSnapshot);
+    }
+
+    // raport: timpul total vs. suma timpilor pe fiecare fisier
+    float slowestMs = 0.0f, sumMs = 0.0f;
+    const char* slowest = "";
+    for (const Asset& a : assets.assets) {
+        sumMs += a.loadMs;
+        if (a.loadMs >= slowestMs) { slowestMs = a.loadMs; slowest = a.path; }
+    }
+    printf("Assets: %d files, %.1f KB in %.2f ms on %d threads (slowest %s %.2f ms, sum %.2f ms)\n",
+           (int)assets.assets.size(), assets.bytesLoaded / 1024.0, assets.wallMs, (int)assets.threads.size(),
+           slowest, slowestMs, sumMs);
+
+    // toate sprite-urile intr-o singura textura, urcata pe GPU de renderer la primul snapshot
+    SpriteAtlas atlas;
+    {
+        std::vector<SDL_Surface*> images;
+        std::vector<SpriteName> names;
+        for (const Asset& a : assets.assets) {
+            if (a.kind != ASSET_IMAGE || !a.ok) continue;
+            SpriteName n;
+            SDL_strlcpy(n.str, a.name, sizeof(n.str));
+            images.push_back(a.image);
+            names.push_back(n);
+        }
+        packSpriteAtlas(atlas, images, names);
+    }
+
+    std::srand(seed);
+
+    // Lumea e de 10x10 ori ecranul, camera urmareste jucatorul
+    const float WORLD_W = WIN_W * 10.0f;
+    const float WORLD_H = WIN_H * 10.0f;
+    Camera cam;
+    cam.w = (float)WIN_W;
+    cam.h = (float)WIN_H;
+    WorldChunks chunks;
+    initWorldChunks(chunks, WORLD_W, WORLD_H, 1024.0f);
+    bool chunkSleep = true;
+    bool showChunks = false;
+
+    // Ziduri si stalpi: BVH construit o data, flow field-ul ocoleste peretii
+    Obstacles obstacles;
+    FlowField flow;
+    bool flowOn = true;
+    std::vector<Uint32> visibleWalls;
+    {
+        Uint64 t0 = SDL_GetPerformanceCounter();
+        std::vector<SDL_FRect> level;
+        parseLevel(assets.assets[levelAsset].path, assets.assets[levelAsset].data, WORLD_W, WORLD_H, level);
+        buildObstacles(obstacles, level);
+        Uint64 t1 = SDL_GetPerformanceCounter();
+        initFlowField(flow, WORLD_W, WORLD_H, 64.0f, obstacles);
+        Uint64 t2 = SDL_GetPerformanceCounter();
+        double freq = (double)SDL_GetPerformanceFrequency();
+        printf("Level: %d obstacles, BVH %d nodes depth %d in %.2f ms, flow field %dx%d in %.2f ms\n",
+               (int)obstacles.rects.size(), (int)obstacles.nodes.size(), obstacles.depth, (t1 - t0) * 1000.0 / freq,
+               flow.cols, flow.rows, (t2 - t1) * 1000.0 / freq);
+    }
 
     // Game objects
     Player player;
-    player.rect = { WIN_W * 0.5f - 16.0f, WIN_H * 0.5f - 16.0f, 32.0f, 32.0f };
+    player.rect = { WORLD_W * 0.5f - 16.0f, WORLD_H * 0.5f - 16.0f, 32.0f, 32.0f };
     player.color = { 200, 200, 60, 255 };
     player.hp = 100;
+    cam.x = WORLD_W * 0.5f - cam.w * 0.5f;
+    cam.y = WORLD_H * 0.5f - cam.h * 0.5f;
+
+    // archetype table + wave scaling; spawning copies a prebuilt template
+    std::vector<MobArchetype> baseArchetypes;
+    std::vector<MobArchetype> archetypes;
+    std::vector<Mob> spawnTemplates;
+    std::vector<int> templateCompactIds;
+    WaveModifiers waveMods;
+    parseMobArchetypes(assets.assets[mobsAsset].path, assets.assets[mobsAsset].data, baseArchetypes);
 
-    Mob enemy;
-    enemy.hp = 10;
-	enemy.dmg = 5;
+    // sprite per archetype (same name as the row in mobs.txt), flat if there is no bitmap
+    std::vector<Uint16> mobTypeSprites;
+    for (const MobArchetype& a : baseArchetypes) mobTypeSprites.push_back(findSprite(atlas, a.name));
+    const Uint16 playerSprite = findSprite(atlas, "player");
+    const Uint16 bulletSprite = findSprite(atlas, "bullet");
+    const Uint16 buffSprite = findSprite(atlas, "buff");
+    const Uint16 gemSprite = findSprite(atlas, "gem");
+
+    WaveDirector director;
+    parseWaveTimeline(assets.assets[wavesAsset].path, assets.assets[wavesAsset].data, baseArchetypes, director.timeline);
+    assetLoaderShutdown(assets);
 
     std::vector<Mob> enemies;
-    std::vector<Entity> bullets;
-	std::vector<Buff_Box> buffs;
+    std::vector<Bullet> bullets;
+    // horde mode: mobs stored as CompactMob + archetype index instead of Mob
+    bool compactMobs = false;
+    std::vector<CompactMob> compactEnemies;
+    std::vector<CompactArchetype> compactArchetypes;
+    std::vector<SDL_FRect> mobRects;
+    std::vector<SDL_Color> mobColors;
+    std::vector<Uint16> mobSprites;
+    BuffPool buffs;
+    initBuffPool(buffs, 64);
+    std::vector<Uint8> buffsTaken;
+    // scantei la lovituri si explozii la moartea mobilor
+    ParticleSystem particles;
+    initParticles(particles, 1 << 16);
+    bool particlesOn = true;
+    // cifre plutitoare cu damage-ul, desenate toate odata in background draw list
+    DamageNumbers damageNumbers;
+    initDamageNumbers(damageNumbers, 256);
+    bool damageNumbersOn = true;
 
     // Parametrii de start
-    float enemySpawnInterval = 1.0f;
-    float enemySpeed = 80.0f;
-    float bulletSpeed = 600.0f;
+    float enemySpeedScale = 1.0f;
     bool autoShoot = true;
-    float fireRate = 6.0f;
+    // statistici jucator: valori de baza + modificatori de la buff-uri, recalculate doar la schimbari
+    StatStack playerStats;
+    setStatBase(playerStats, STAT_FIRE_RATE, 6.0f);
+    setStatBase(playerStats, STAT_BULLET_SPEED, 600.0f);
+    setStatBase(playerStats, STAT_BULLET_DAMAGE, (float)player.dmg);
+    setStatBase(playerStats, STAT_MOVE_SPEED, player.speed);
+    updateStats(playerStats, 0.0f);
     int maxEnemies = 500;
-    float enemySpawnTimer = 0.0f;
-    float fireTimer = 0.0f;
-    float enemySize = 24.0f;
+    // pana la 6 arme, toate trag in acelasi batch
+    WeaponSet weapons;
+    addWeapon(weapons, 0);
     int lastSpawnSecond = -1;
 	int lastSpawnSecondEn = -1;
 
-    bool running = true;
-    SDL_Event e;
+    // tintire: cel mai apropiat mob din grid (auto-aim) si gloante care urmaresc tinta
+    enum AimMode { AIM_MOUSE = 0, AIM_NEAREST };
+    int aimMode = AIM_MOUSE;
+    float aimRange = 900.0f;
+    bool homingBullets = false;
+    float homingRange = 450.0f;
+    float homingTurn = 7.0f; // rad/s
+    SpatialGrid mobGrid;
+    std::vector<Vec2> mobCenters;
+    std::vector<Uint32> mobIds;
+    std::vector<Uint32> homingIds;
+    std::vector<Vec2> homingPos;
+    std::vector<NearestHit> homingHits;
+
+    // gloante care trec prin mobi / ricoseaza, fiecare tine minte pe cine a lovit
+    int bulletPierce = 0;
+    int bulletBounces = 0;
+    BulletCollision bulletCollision;
+    std::vector<Uint32> mobRemap;
+
+    // arme cu damage pe zona: gloante explozive si lovitura melee in con
+    bool explosiveBullets = false;
+    float explosionRadius = 90.0f;
+    bool meleeOn = false;
+    float meleeInterval = 0.5f;
+    float meleeRadius = 140.0f;
+    float meleeHalfAngle = 1.0f; // rad
+    float meleeTimer = 0.0f;
+    // damage-ul e colectat ca evenimente si aplicat o data pe frame, mortile merg mai departe
+    DamageQueue damageQueue;
+    int kills = 0;
+    int killsBySource[2] = { 0, 0 };
+
+    // XP: fiecare mob mort lasa un gem, atras de jucator cand e aproape
+    XpGems gems;
+    initXpGems(gems, 1 << 16);
+    Uint64 playerXp = 0;
+    std::vector<Vec2> explosions;
+
+    // LOD pentru mobii departe de player / in afara ecranului
+    LodSettings lod;
+    SteerSlicing steer;
+    LodStats lodStats{};
+    VisibleSet visible;
+    Uint32 frameIndex = 0;
+    Uint8 nextLodBucket = 0;
+
+    // headless runs must not depend on how fast this machine is
+    double simTime = 0.0;
+    double renderMsTotal = 0.0;
+    if (headless) {
+        steer.adaptive = false;
+        director.budgetUs = 1e9f;
+    }
+
+    auto rebuildArchetypes = [&]() {
+        applyWaveModifiers(baseArchetypes, waveMods, archetypes);
+        buildSpawnTemplates(archetypes, spawnTemplates);
+        // randurile vechi raman doar cat timp mai traieste un mob din valul lor
+        pruneArchetypes(compactArchetypes, compactEnemies);
+        templateCompactIds.resize(spawnTemplates.size());
+        for (size_t i = 0; i < spawnTemplates.size(); ++i) {
+            const Mob& t = spawnTemplates[i];
+            CompactArchetype a{ t.rect.w, t.color, t.dmg, t.speed, t.type };
+            templateCompactIds[i] = findOrAddArchetype(compactArchetypes, a);
+            if (templateCompactIds[i] < 0) {
+                templateCompactIds[i] = nearestArchetype(compactArchetypes, a);
+                printf("Compact archetype table full (%d rows), '%s' spawns with the closest row\n",
+                       MAX_MOB_ARCHETYPES, archetypes[i].name);
+            }
+        }
+    };
+    rebuildArchetypes();
+
+    auto enemyCount = [&]() {
+        return compactMobs ? compactEnemies.size() : enemies.size();
+    };
+
+    // spawn de mobi la marginile camerei
+    auto spawnEdgeMob = [&](int type) {
+        Mob en = spawnTemplates[type];
+        en.lodBucket = nextLodBucket++;
+        float s = en.rect.w;
+        int edge = std::rand() % 4;
+        if (edge == 0) { // top
+            en.rect.x = cam.x + float(std::rand() % WIN_W);
+            en.rect.y = cam.y - s - 1;
+        }
+        else if (edge == 1) { // bottom
+            en.rect.x = cam.x + float(std::rand() % WIN_W);
+            en.rect.y = cam.y + WIN_H + 1;
+        }
+        else if (edge == 2) { // left
+            en.rect.x = cam.x - s - 1;
+            en.rect.y = cam.y + float(std::rand() % WIN_H);
+        }
+        else { // right
+            en.rect.x = cam.x + WIN_W + 1;
+            en.rect.y = cam.y + float(std::rand() % WIN_H);
+        }
+        Vec2 dir{ player.rect.x + player.rect.w * 0.5f - (en.rect.x + s * 0.5f),
+                   player.rect.y + player.rect.h * 0.5f - (en.rect.y + s * 0.5f) };
+        dir = normalize(dir);
+        en.velocity = { dir.x * en.speed * enemySpeedScale, dir.y * en.speed * enemySpeedScale };
+
+        if (compactMobs) {
+            compactEnemies.push_back(packMob(en, (Uint8)templateCompactIds[type]));
+        }
+        else {
+            enemies.push_back(en);
+        }
+    };
     
     Uint64 startTime = SDL_GetTicks();
 
@@ -148,8 +452,13 @@ int main(int argc, char** argv)
 
         last = now;
         if (deltaTime > 0.1f) deltaTime = 0.1f;
+        if (headless) {
+            deltaTime = 1.0f / 60.0f;
+            gameTime = (float)simTime;
+            simTime += deltaTime;
+        }
 
-        while (SDL_PollEvent(&e)) {
+        while (!headless && SDL_PollEvent(&e)) {
             ImGui_ImplSDL3_ProcessEvent(&e);
             if (e.type == SDL_EVENT_QUIT) running = false;
             if (e.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) running = false;
@@ -158,112 +467,83 @@ int main(int argc, char** argv)
         // Input
         const bool* kb = SDL_GetKeyboardState(NULL);
         Vec2 move{ 0,0 };
-        if (kb[SDL_SCANCODE_W]) move.y -= 1;
-        if (kb[SDL_SCANCODE_S]) move.y += 1;
-        if (kb[SDL_SCANCODE_A]) move.x -= 1;
-        if (kb[SDL_SCANCODE_D]) move.x += 1;
+        if (!headless) {
+            if (kb[SDL_SCANCODE_W]) move.y -= 1;
+            if (kb[SDL_SCANCODE_S]) move.y += 1;
+            if (kb[SDL_SCANCODE_A]) move.x -= 1;
+            if (kb[SDL_SCANCODE_D]) move.x += 1;
+        }
+        obstaclesBeginFrame(obstacles);
         Vec2 moveN = normalize(move);
         player.rect.x += moveN.x * player.speed * deltaTime;
         player.rect.y += moveN.y * player.speed * deltaTime;
         
         if (player.rect.x < 0) player.rect.x = 0;
         if (player.rect.y < 0) player.rect.y = 0;
-        if (player.rect.x + player.rect.w > WIN_W) player.rect.x = WIN_W - player.rect.w;
-        if (player.rect.y + player.rect.h > WIN_H) player.rect.y = WIN_H - player.rect.h;
+        if (player.rect.x + player.rect.w > WORLD_W) player.rect.x = WORLD_W - player.rect.w;
+        if (player.rect.y + player.rect.h > WORLD_H) player.rect.y = WORLD_H - player.rect.h;
+        obstaclePushOut(obstacles, player.rect, obstacles.stats);
+
+        updateCamera(cam, { player.rect.x + player.rect.w * 0.5f, player.rect.y + player.rect.h * 0.5f }, WORLD_W, WORLD_H, deltaTime);
+        const SDL_FRect view = cameraView(cam);
 
         // Mouse
         float mx = 0.0f, my = 0.0f;
-        SDL_GetMouseState(&mx, &my);
-
-        // Auto Shooting
-        fireTimer += deltaTime;
-        if (autoShoot && fireTimer >= 1.0f / fireRate) {
-            fireTimer = 0.0f;
-            
-            Vec2 dir{ (float)mx - (player.rect.x + player.rect.w * 0.5f),
-                       (float)my - (player.rect.y + player.rect.h * 0.5f) };
-            dir = normalize(dir);
-            Entity b;
-            b.rect = { player.rect.x + player.rect.w * 0.5f - 4.0f,
-                       player.rect.y + player.rect.h * 0.5f - 4.0f,
-                       8.0f, 8.0f };
-            b.color = { 255, 255, 120, 255 };
-            b.velocity = { dir.x * bulletSpeed, dir.y * bulletSpeed };
-            bullets.push_back(b);
+        if (headless) {
+            // tinta care se roteste in jurul jucatorului
+            mx = player.rect.x + player.rect.w * 0.5f + 300.0f * std::cos(frameIndex * 0.02f);
+            my = player.rect.y + player.rect.h * 0.5f + 300.0f * std::sin(frameIndex * 0.02f);
+        }
+        else {
+            SDL_GetMouseState(&mx, &my);
+            mx += cam.x;
+            my += cam.y;
+        }
+
+        // Tinta: mouse sau cel mai apropiat mob (grid din frame-ul trecut, doar pozitiile conteaza)
+        Vec2 aimFrom{ player.rect.x + player.rect.w * 0.5f, player.rect.y + player.rect.h * 0.5f };
+        Vec2 aimTarget{ mx, my };
+        if (aimMode == AIM_NEAREST) {
+            NearestHit h = gridNearest(mobGrid, aimFrom, aimRange);
+            if (h.id != GRID_NONE) aimTarget = h.pos;
+        }
+        Vec2 aimDir = normalize({ aimTarget.x - aimFrom.x, aimTarget.y - aimFrom.y });
+
+        // Auto Shooting: toate armele, cu timpul ramas pastrat intre frame-uri
+        {
+            PROFILE_SCOPE("Weapons");
+            Bullet proto;
+            proto.pierce = (Uint8)std::min(bulletPierce, BULLET_MAX_PIERCE);
+            proto.bounces = (Uint8)std::min(bulletBounces, BULLET_MAX_BOUNCES);
+            if (homingBullets) {
+                proto.flags |= BULLET_HOMING;
+                proto.color = { 120, 230, 255, 255 };
+            }
+            if (explosiveBullets) {
+                proto.flags |= BULLET_EXPLOSIVE;
+                proto.color = { 255, 150, 60, 255 };
+            }
+            fireWeapons(weapons, deltaTime, autoShoot, aimFrom, aimDir, statValue(playerStats, STAT_FIRE_RATE),
+                        statValue(playerStats, STAT_BULLET_SPEED), proto, bullets);
+            profileCounter("Bullets fired", weapons.shots);
         }
 
         // space - spawn manual de mobi
         static bool spacePrev = false;
         const bool* kb2 = SDL_GetKeyboardState(NULL);
-        bool spaceNow = kb2[SDL_SCANCODE_SPACE];
+        bool spaceNow = !headless && kb2[SDL_SCANCODE_SPACE];
         if (spaceNow && !spacePrev) {
             // burst spawn de mobi
-            for (int i = 0; i < 5 && enemies.size() < (size_t)maxEnemies; ++i) {
-				// spawn de mobi la margini
-                Mob en;
-                float s = enemySize;
-                int edge = std::rand() % 4;
-                if (edge == 0) { // top
-                    en.rect.x = float(std::rand() % WIN_W);
-                    en.rect.y = -s - 1;
-                }
-                else if (edge == 1) { // bottom
-                    en.rect.x = float(std::rand() % WIN_W);
-                    en.rect.y = WIN_H + 1;
-                }
-                else if (edge == 2) { // left
-                    en.rect.x = -s - 1;
-                    en.rect.y = float(std::rand() % WIN_H);
-                }
-                else { // right
-                    en.rect.x = WIN_W + 1;
-                    en.rect.y = float(std::rand() % WIN_H);
-                }
-                en.rect.w = s; en.rect.h = s;
-                en.color = { 200, 80, 80, 255 };
-                Vec2 dir{ player.rect.x + player.rect.w * 0.5f - (en.rect.x + s * 0.5f),
-                           player.rect.y + player.rect.h * 0.5f - (en.rect.y + s * 0.5f) };
-                dir = normalize(dir);
-                en.velocity = { dir.x * enemySpeed, dir.y * enemySpeed };
-                en.alive = true;
-                enemies.push_back(en);
-            }
+            queueSpawns(director, 5, archetypes);
         }
         spacePrev = spaceNow;
 
-        // spawn automat de mobi
-        enemySpawnTimer += deltaTime;
-        if (enemySpawnTimer >= enemySpawnInterval) {
-            enemySpawnTimer = 0.0f;
-            if (enemies.size() < (size_t)maxEnemies) {
-                Mob en;
-                float s = enemySize;
-                int edge = std::rand() % 4;
-                if (edge == 0) { // top
-                    en.rect.x = float(std::rand() % WIN_W);
-                    en.rect.y = -s - 1;
-                }
-                else if (edge == 1) { // bottom
-                    en.rect.x = float(std::rand() % WIN_W);
-                    en.rect.y = WIN_H + 1;
-                }
-                else if (edge == 2) { // left
-                    en.rect.x = -s - 1;
-                    en.rect.y = float(std::rand() % WIN_H);
-                }
-                else { // right
-                    en.rect.x = WIN_W + 1;
-                    en.rect.y = float(std::rand() % WIN_H);
-                }
-                en.rect.w = s; en.rect.h = s;
-                en.color = { 200, 80, 80, 255 };
-                Vec2 dir{ player.rect.x + player.rect.w * 0.5f - (en.rect.x + s * 0.5f),
-                           player.rect.y + player.rect.h * 0.5f - (en.rect.y + s * 0.5f) };
-                dir = normalize(dir);
-                en.velocity = { dir.x * enemySpeed, dir.y * enemySpeed };
-                en.alive = true;
-                enemies.push_back(en);
-            }
+        // spawn automat de mobi, amortizat pe mai multe frame-uri
+        updateWaveDirector(director, gameTime, deltaTime, archetypes);
+        size_t room = (size_t)maxEnemies > enemyCount() ? (size_t)maxEnemies - enemyCount() : 0;
+        {
+            PROFILE_SCOPE("Spawn");
+            drainSpawnQueue(director, room, spawnEdgeMob);
         }
 
         // Update bullets
@@ -271,47 +551,201 @@ int main(int argc, char** argv)
             bullets[i].rect.x += bullets[i].velocity.x * deltaTime;
             bullets[i].rect.y += bullets[i].velocity.y * deltaTime;
 			// dispar daca ies din ecran
-            if (bullets[i].rect.x < -50 || bullets[i].rect.x > WIN_W + 50 ||
-                bullets[i].rect.y < -50 || bullets[i].rect.y > WIN_H + 50) {
+            if (bullets[i].rect.x < view.x - 50 || bullets[i].rect.x > view.x + view.w + 50 ||
+                bullets[i].rect.y < view.y - 50 || bullets[i].rect.y > view.y + view.h + 50) {
                 bullets[i].alive = false;
             }
         }
+        {
+            PROFILE_SCOPE("Walls (bullets)");
+            collideBulletsWithObstacles(obstacles, bullets, deltaTime);
+        }
+
+        Vec2 playerCenter{ player.rect.x + player.rect.w * 0.5f, player.rect.y + player.rect.h * 0.5f };
+        CombatFx combatFx;
+        if (particlesOn) combatFx.particles = &particles;
+        if (damageNumbersOn) combatFx.numbers = &damageNumbers;
+
+        // Chunk-uri: active langa camera, coarse mai departe, restul dorm
+        {
+            PROFILE_SCOPE("Chunks");
+            updateChunkStates(chunks, view);
+            bucketEntities(chunks, enemies); // empty in compact mode, keeps the buckets in sync
+            profileCounter("Chunks active", chunks.chunksByState[CHUNK_ACTIVE]);
+            profileCounter("Chunks coarse", chunks.chunksByState[CHUNK_COARSE]);
+            profileCounter("Chunks sleeping", chunks.chunksByState[CHUNK_SLEEP]);
+        }
+        const WorldChunks* simChunks = chunkSleep ? &chunks : nullptr;
+
+        // Flow field spre jucator, refacut doar cand jucatorul schimba celula
+        {
+            PROFILE_SCOPE("Flow field");
+            if (flowOn && updateFlowField(flow, playerCenter)) {
+                profileCounter("Flow rebuild (ms)", flow.buildMs);
+                profileCounter("Flow cells reached", flow.cellsReached);
+            }
+        }
+        const FlowField* simFlow = flowOn ? &flow : nullptr;
+
+        if (compactMobs) {
+            updateCompactMobs(compactEnemies, compactArchetypes, playerCenter, enemySpeedScale, deltaTime, simChunks, simFlow);
+        }
 
         // Update enemies
-        for (size_t i = 0; i < enemies.size(); ++i) {
-			// urmarirea playerului de catre mobi
-            Vec2 toPlayer{ (player.rect.x + player.rect.w * 0.5f) - (enemies[i].rect.x + enemies[i].rect.w * 0.5f),
-                           (player.rect.y + player.rect.h * 0.5f) - (enemies[i].rect.y + enemies[i].rect.h * 0.5f) };
-            Vec2 dir = normalize(toPlayer);
-            enemies[i].velocity.x = dir.x * enemySpeed;
-            enemies[i].velocity.y = dir.y * enemySpeed;
-
-            enemies[i].rect.x += enemies[i].velocity.x * deltaTime;
-            enemies[i].rect.y += enemies[i].velocity.y * deltaTime;
-        }
-
-		// Collision intre mobi si gloante
-        for (size_t bi = 0; bi < bullets.size(); ++bi) {
-            if (!bullets[bi].alive) continue;
-            for (size_t ei = 0; ei < enemies.size(); ++ei) {
-                if (!enemies[ei].alive) continue;
-                if (aabb(bullets[bi].rect, enemies[ei].rect)) {
-                    bullets[bi].alive = false;
-                    enemies[ei].hp -= player.dmg;
-                    break;
+        {
+            static const int mobZone = profileRegister("Mobs");
+            Uint64 t0 = SDL_GetPerformanceCounter();
+            updateMobsLod(enemies, playerCenter, enemySpeedScale, deltaTime, frameIndex, view, lod, steer, lodStats, simChunks, simFlow);
+            Uint64 ticks = SDL_GetPerformanceCounter() - t0;
+            profileAdd(mobZone, ticks);
+            adaptSteerSlices(steer, (float)(ticks * 1000.0 / perfFreq));
+
+            // estimate of what the skipped updates would have cost at the measured per-mob rate
+            double perMobMs = lodStats.updated > 0 ? ticks * 1000.0 / perfFreq / lodStats.updated : 0.0;
+            profileCounter("LOD near", lodStats.tierCount[LOD_NEAR]);
+            profileCounter("LOD mid", lodStats.tierCount[LOD_MID]);
+            profileCounter("LOD far", lodStats.tierCount[LOD_FAR]);
+            profileCounter("LOD skipped updates", lodStats.skipped);
+            profileCounter("LOD saved (ms, est)", perMobMs * lodStats.skipped);
+            profileCounter("Steer slices", steer.slices);
+            profileCounter("Steer retargets", lodStats.retargeted);
+            profileCounter("Mobs sleeping", lodStats.sleeping);
+        }
+
+        // Mobii nu intra in ziduri
+        {
+            PROFILE_SCOPE("Walls (mobs)");
+            if (compactMobs) collideCompactMobsWithObstacles(compactEnemies, compactArchetypes, obstacles);
+            else collideEntitiesWithObstacles(obstacles, enemies);
+        }
+
+        // Broadphase pentru tintire + gloante care urmaresc cel mai apropiat mob
+        {
+            PROFILE_SCOPE("Targeting");
+            // ids = index in enemies / compactEnemies, the area damage pass writes through them
+            mobCenters.clear();
+            mobIds.clear();
+            std::vector<SDL_FRect>& mobRects = bulletCollision.mobRects;
+            mobRects.resize(enemyCount());
+            float maxMobSize = 0.0f;
+            if (compactMobs) {
+                for (size_t i = 0; i < compactEnemies.size(); ++i) {
+                    const CompactMob& m = compactEnemies[i];
+                    if (!(m.flags & COMPACT_MOB_ALIVE)) continue;
+                    float size = compactArchetypes[m.archetype].size;
+                    mobRects[i] = { fromFixed(m.x), fromFixed(m.y), size, size };
+                    mobCenters.push_back({ mobRects[i].x + size * 0.5f, mobRects[i].y + size * 0.5f });
+                    mobIds.push_back((Uint32)i);
+                    maxMobSize = std::max(maxMobSize, size);
                 }
-                if (enemies[ei].hp <= 0) {
-                    enemies[ei].alive = false;
-				}
             }
+            else {
+                for (size_t i = 0; i < enemies.size(); ++i) {
+                    const Mob& m = enemies[i];
+                    if (!m.alive) continue;
+                    mobRects[i] = m.rect;
+                    mobCenters.push_back({ m.rect.x + m.rect.w * 0.5f, m.rect.y + m.rect.h * 0.5f });
+                    mobIds.push_back((Uint32)i);
+                    maxMobSize = std::max(maxMobSize, std::max(m.rect.w, m.rect.h));
+                }
+            }
+            bulletCollision.maxMobSize = maxMobSize;
+            buildSpatialGrid(mobGrid, mobCenters.data(), mobIds.data(), mobCenters.size(), 64.0f);
+
+            homingIds.clear();
+            homingPos.clear();
+            for (size_t i = 0; i < bullets.size(); ++i) {
+                const Bullet& b = bullets[i];
+                if (!b.alive || !(b.flags & BULLET_HOMING)) continue;
+                homingIds.push_back((Uint32)i);
+                homingPos.push_back({ b.rect.x + b.rect.w * 0.5f, b.rect.y + b.rect.h * 0.5f });
+            }
+            homingHits.resize(homingIds.size());
+            gridNearestBatch(mobGrid, homingPos.data(), homingPos.size(), homingRange, homingHits.data());
+
+            // roteste viteza spre tinta cu cel mult homingTurn rad/s
+            float maxTurn = homingTurn * deltaTime;
+            for (size_t k = 0; k < homingIds.size(); ++k) {
+                if (homingHits[k].id == GRID_NONE) continue;
+                Bullet& b = bullets[homingIds[k]];
+                float speed = std::sqrt(b.velocity.x * b.velocity.x + b.velocity.y * b.velocity.y);
+                float cur = std::atan2(b.velocity.y, b.velocity.x);
+                float want = std::atan2(homingHits[k].pos.y - homingPos[k].y, homingHits[k].pos.x - homingPos[k].x);
+                float diff = std::remainder(want - cur, 6.2831853f);
+                float a = cur + std::max(-maxTurn, std::min(maxTurn, diff));
+                b.velocity = { std::cos(a) * speed, std::sin(a) * speed };
+            }
+            profileCounter("Homing queries", (double)homingIds.size());
+        }
+
+		// Collision intre mobi si gloante: detectie in paralel pe gloante, doar evenimente de damage
+        {
+            PROFILE_SCOPE("Collision");
+            detectBulletHits(bulletCollision, bullets, mobGrid, damageQueue, player.dmg);
+            profileCounter("Collision candidates", (double)bulletCollision.candidates);
+            profileCounter("Bullet hits", (double)bulletCollision.hits);
+        }
+
+        // Damage pe zona: explozii + melee, tot ca evenimente
+        {
+            PROFILE_SCOPE("Area Damage");
+            explosions.clear();
+            for (const std::vector<DamageEvent>& chunk : damageQueue.chunks) {
+                for (const DamageEvent& e : chunk) {
+                    const Bullet& b = bullets[e.attacker];
+                    if (b.flags & BULLET_EXPLOSIVE) explosions.push_back({ b.rect.x + b.rect.w * 0.5f, b.rect.y + b.rect.h * 0.5f });
+                }
+            }
+            for (Vec2 c : explosions) {
+                areaCircle(damageQueue, mobGrid, c, explosionRadius, player.dmg);
+                fxExplosion(combatFx, c, explosionRadius);
+            }
+
+            meleeTimer += deltaTime;
+            if (meleeOn && meleeTimer >= meleeInterval) {
+                meleeTimer = 0.0f;
+                areaCone(damageQueue, mobGrid, aimFrom, aimDir, meleeRadius, meleeHalfAngle, player.dmg * 2);
+                fxSwing(combatFx, aimFrom, aimDir, meleeRadius, meleeHalfAngle);
+            }
+        }
+
+        // Rezolvare: sortat pe tinta, damage aplicat o data, mortile trimise la efecte/scor
+        {
+            PROFILE_SCOPE("Damage");
+            if (compactMobs) resolveDamageCompact(damageQueue, compactEnemies, compactArchetypes, bullets, combatFx);
+            else resolveDamage(damageQueue, enemies, bullets, combatFx);
+            for (const DeathEvent& d : damageQueue.deaths) {
+                fxMobDeath(combatFx, d.rect, d.color);
+                kills++;
+                killsBySource[d.source]++;
+                dropXpGem(gems, d.rect.x + d.rect.w * 0.5f, d.rect.y + d.rect.h * 0.5f,
+                          (Uint32)std::max(1, (int)(d.rect.w / 8.0f)));
+            }
+            profileCounter("Damage events", damageQueue.eventCount);
+            profileCounter("Damage targets", damageQueue.targetCount);
+            profileCounter("Kills", (double)damageQueue.deaths.size());
         }
 
         // Enemy vs player
         int p_r = 0, p_g = 0, p_b = 0;
+        if (compactMobs) {
+            int dmgTaken = 0;
+            int hits = collidePlayerCompact(compactEnemies, compactArchetypes, player.rect, dmgTaken, combatFx);
+            for (int h = 0; h < hits; ++h) {
+                p_r += 20;
+                p_g += 20;
+                p_b += 20;
+                player.color.r -= p_r;
+                player.color.g -= p_g;
+                player.color.b += p_b;
+            }
+            player.hp -= dmgTaken;
+        }
         for (size_t ei = 0; ei < enemies.size(); ++ei) {
             if (!enemies[ei].alive) continue;
             if (aabb(enemies[ei].rect, player.rect)) {
                 enemies[ei].alive = false;
+                fxMobDeath(combatFx, enemies[ei].rect, enemies[ei].color);
                 p_r += 20;
                 p_g += 20;
                 p_b += 20;
@@ -322,51 +756,46 @@ int main(int argc, char** argv)
             }
         }
 
-        // Buffs
+        {
+            PROFILE_SCOPE("Particles");
+            updateParticles(particles, deltaTime);
+            updateDamageNumbers(damageNumbers, deltaTime);
+            profileCounter("Particles live", particles.alive);
+            profileCounter("Damage numbers", damageNumbers.count);
+        }
+
+        {
+            PROFILE_SCOPE("Pickups");
+            Vec2 center{ player.rect.x + player.rect.w * 0.5f, player.rect.y + player.rect.h * 0.5f };
+            playerXp += updateXpGems(gems, center, deltaTime);
+            profileCounter("Gems", gems.count);
+            profileCounter("Gems magnet", (double)gems.active.size());
+        }
+
+        // Buffs: unul la 45 s, tip ales uniform din tabel
         int currentSecond = (int)gameTime;
         if (currentSecond % 45 == 0 && currentSecond != lastSpawnSecond) {
-            Buff_Box buff;
-            buff.rect = { (float)(std::rand() % (WIN_W - 32)),
-                          (float)(std::rand() % (WIN_H - 32)),
-                          32.0f, 32.0f };
-            buff.type = static_cast<Buff_Box::Type>(std::rand() % 4);
-            buff.alive = true;
-
-			// culoare diferita in functie de tip
-            switch (buff.type) {
-                case Buff_Box::Type::FIRE_RATE:    buff.color = { 255, 0, 0, 255 }; break;
-                case Buff_Box::Type::BULLET_SPEED: buff.color = { 0, 255, 0, 255 }; break;
-                case Buff_Box::Type::HEAL:         buff.color = { 0, 0, 255, 255 }; break;
-                case Buff_Box::Type::FIRE_MODE:    buff.color = { 255, 255, 0, 255 }; break;
-				case Buff_Box::Type::BULLET_DAMAGE: buff.color = { 255, 0, 255, 255 }; break;
-            }
-
-            buffs.push_back(buff);
+            SDL_FRect r{ cam.x + (float)(std::rand() % (WIN_W - 32)), cam.y + (float)(std::rand() % (WIN_H - 32)), 32.0f, 32.0f };
+            obstaclePushOut(obstacles, r, obstacles.stats);
+            spawnBuff(buffs, r, (Uint8)(std::rand() % BUFF_EFFECT_COUNT));
             lastSpawnSecond = currentSecond;
         }
 
-        // Update si coliziuni
-        for (auto& buff : buffs) {
-            if (buff.alive && aabb(player.rect, buff.rect)) {
-                // efect in functie de tip
-                switch (buff.type) {
-                    case Buff_Box::Type::HEAL: player.hp += 10; break;
-                    case Buff_Box::Type::FIRE_RATE: fireRate *= 1.2f; break;
-                    case Buff_Box::Type::BULLET_SPEED: bulletSpeed *= 1.2f; break;
-                    case Buff_Box::Type::FIRE_MODE: autoShoot = !autoShoot; break;
-					case Buff_Box::Type::BULLET_DAMAGE: player.dmg += 2; break;
-                }
-                buff.alive = false;
-            }
+        // Update si coliziuni, efectele trec prin tabel si stiva de modificatori
+        updateBuffPool(buffs, player.rect, deltaTime, buffsTaken);
+        for (Uint8 effect : buffsTaken) applyBuffEffect(BUFF_EFFECTS[effect], playerStats, player.hp, autoShoot);
+        if (updateStats(playerStats, deltaTime)) {
+            player.dmg = (int)statValue(playerStats, STAT_BULLET_DAMAGE);
+            player.speed = statValue(playerStats, STAT_MOVE_SPEED);
         }
 
         // Update GamePlay
         int currentSecondEn = (int)gameTime;
         if (currentSecondEn % 60 == 0 && currentSecondEn != 0 && currentSecondEn != lastSpawnSecondEn ) {
-            enemySpawnInterval = std::max(0.5f, (enemySpawnInterval - 0.05f));
-            enemySize = std::min(200.0f, enemySize + 2.0f);
-			enemy.dmg += 2;
-			enemy.hp += 5;
+            waveMods.size += 2.0f;
+            waveMods.dmg += 2;
+            waveMods.hp += 5;
+            rebuildArchetypes();
             lastSpawnSecondEn = currentSecondEn;
         }
 
@@ -381,8 +810,17 @@ int main(int argc, char** argv)
             }
             vec.resize(dst);
         };
+        // istoricul de lovituri al gloantelor tine indici de mobi, ii mutam odata cu ei
+        mobRemap.resize(enemyCount());
+        Uint32 mobNext = 0;
+        for (size_t i = 0; i < mobRemap.size(); ++i) {
+            bool alive = compactMobs ? (compactEnemies[i].flags & COMPACT_MOB_ALIVE) != 0 : enemies[i].alive;
+            mobRemap[i] = alive ? mobNext++ : GRID_NONE;
+        }
         compactEntities(bullets);
+        remapBulletHits(bullets, mobRemap);
         compactEntities(enemies);
+        removeDeadCompact(compactEnemies);
 
 		// Resetam culoarea jucatorului treptat dupa ce nu mai e lovit
         if (player.color.r > 200) {
@@ -390,96 +828,274 @@ int main(int argc, char** argv)
             if (player.color.r < 200) player.color.r = 200;
         }
 
+        // Culling: doar ce se vede ajunge in snapshot
+        {
+            PROFILE_SCOPE("Cull");
+            if (compactMobs) {
+                compactToRects(compactEnemies, compactArchetypes, mobTypeSprites, mobRects, mobColors, mobSprites);
+                cullRects(mobRects.data(), sizeof(SDL_FRect), mobRects.size(), view, visible.indices[CULL_MOBS]);
+            }
+            else {
+                cullEntities(enemies, view, visible.indices[CULL_MOBS]);
+            }
+            cullEntities(bullets, view, visible.indices[CULL_BULLETS]);
+            cullRects(buffs.rect.data(), sizeof(SDL_FRect), buffs.count, view, visible.indices[CULL_BUFFS]);
+            visible.total[CULL_MOBS] = (int)enemyCount();
+            visible.total[CULL_BULLETS] = (int)bullets.size();
+            visible.total[CULL_BUFFS] = buffs.count;
+            obstacleQueryBox(obstacles, view, visibleWalls, obstacles.stats);
+        }
+        profileCounter("Wall ray queries", obstacles.stats.rayQueries);
+        profileCounter("Wall ray hits", obstacles.stats.rayHits);
+        profileCounter("Wall box queries", obstacles.stats.boxQueries);
+        profileCounter("Wall pushes", obstacles.stats.pushed);
+        profileCounter("BVH nodes visited", obstacles.stats.nodesVisited);
+
         // ImGui frame
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplSDL3_NewFrame();
+        if (headless) io.DeltaTime = deltaTime;
+        else ImGui_ImplSDL3_NewFrame();
         ImGui::NewFrame();
+        drawDamageNumbers(damageNumbers, ImGui::GetBackgroundDrawList(), ImVec2(cam.x, cam.y));
 
-        ImGui::Begin("Debug / Controls");
-        ImGui::Separator();
-		ImGui::Text("Game Time: %.2f s", gameTime);
-        ImGui::Separator();
-        ImGui::Text("Player HP: %d", player.hp);
-        ImGui::Text("Player HP: %d", player.dmg);
-        ImGui::Checkbox("Auto Shoot", &autoShoot);
-        ImGui::SliderFloat("Fire Rate (shots/s)", &fireRate, 0.5f, 20.0f);
-        ImGui::SliderFloat("Bullet Speed", &bulletSpeed, 100.0f, 1200.0f);
-        ImGui::Separator();
-        ImGui::Text("Mob HP: %d", enemy.hp);
-        ImGui::Text("Mob Size: %d", int(enemySize));
-        ImGui::Text("Enemies: %zu", enemies.size());
-        ImGui::SliderFloat("Enemy Spawn Interval (s)", &enemySpawnInterval, 0.05f, 3.0f);
-        ImGui::SliderFloat("Enemy Speed", &enemySpeed, 10.0f, 500.0f);
-        ImGui::SliderInt("Max Enemies", &maxEnemies, 10, 5000);
-        if (ImGui::Button("Clear Enemies")) enemies.clear();
-        if (ImGui::Button("Clear Bullets")) bullets.clear();
-        if (ImGui::Button("Spawn 10 Enemies")) {
-            for (int i = 0; i < 10 && enemies.size() < (size_t)maxEnemies; i++) {
-                Mob en;
-                float s = enemySize;
-                int edge = std::rand() % 4;
-                if (edge == 0) { en.rect.x = float(std::rand() % WIN_W); en.rect.y = -s - 1; }
-                else if (edge == 1) { en.rect.x = float(std::rand() % WIN_W); en.rect.y = WIN_H + 1; }
-                else if (edge == 2) { en.rect.x = -s - 1; en.rect.y = float(std::rand() % WIN_H); }
-                else { en.rect.x = WIN_W + 1; en.rect.y = float(std::rand() % WIN_H); }
-                en.rect.w = s; en.rect.h = s;
-                en.color = { 200, 80, 80, 255 };
-                Vec2 dir{ player.rect.x + player.rect.w * 0.5f - (en.rect.x + s * 0.5f),
-                           player.rect.y + player.rect.h * 0.5f - (en.rect.y + s * 0.5f) };
-                dir = normalize(dir);
-                en.velocity = { dir.x * enemySpeed, dir.y * enemySpeed };
-                en.alive = true;
-                enemies.push_back(en);
+        if (!headless || headlessUi) {
+            ImGui::Begin("Debug / Controls");
+            ImGui::Separator();
+    		ImGui::Text("Game Time: %.2f s", gameTime);
+            ImGui::Separator();
+            ImGui::Text("Player HP: %d", player.hp);
+            ImGui::Text("Player HP: %d", player.dmg);
+            ImGui::Checkbox("Auto Shoot", &autoShoot);
+            ImGui::RadioButton("Aim Mouse", &aimMode, AIM_MOUSE);
+            ImGui::SameLine();
+            ImGui::RadioButton("Aim Nearest", &aimMode, AIM_NEAREST);
+            ImGui::Checkbox("Homing Bullets", &homingBullets);
+            ImGui::SliderFloat("Homing Turn (rad/s)", &homingTurn, 0.5f, 20.0f);
+            if (ImGui::TreeNode("Weapons")) {
+                for (int s = 0; s < weapons.count; ++s) {
+                    ImGui::PushID(s);
+                    int def = weapons.slots[s].def;
+                    ImGui::SetNextItemWidth(120.0f);
+                    if (ImGui::Combo("##def", &def, [](void*, int i) { return WEAPON_DEFS[i].name; }, nullptr, WEAPON_DEF_COUNT)) {
+                        weapons.slots[s].def = (Uint8)def;
+                    }
+                    ImGui::SameLine();
+                    bool remove = ImGui::SmallButton("Remove");
+                    ImGui::PopID();
+                    if (remove) {
+                        removeWeapon(weapons, s);
+                        break;
+                    }
+                }
+                if (weapons.count < MAX_WEAPONS && ImGui::SmallButton("Add Weapon")) addWeapon(weapons, 0);
+                ImGui::Text("Last frame: %d volleys, %d bullets", weapons.volleys, weapons.shots);
+                ImGui::TreePop();
+            }
+            ImGui::SliderInt("Bullet Pierce", &bulletPierce, 0, BULLET_MAX_PIERCE);
+            ImGui::SliderInt("Bullet Ricochets", &bulletBounces, 0, BULLET_MAX_BOUNCES);
+            ImGui::Checkbox("Explosive Bullets", &explosiveBullets);
+            ImGui::SliderFloat("Explosion Radius", &explosionRadius, 20.0f, 300.0f);
+            ImGui::Checkbox("Melee Swing", &meleeOn);
+            ImGui::SliderFloat("Melee Radius", &meleeRadius, 40.0f, 400.0f);
+            ImGui::SliderAngle("Melee Half Angle", &meleeHalfAngle, 5.0f, 180.0f);
+            ImGui::Text("Kills: %d (bullets %d, area %d)", kills, killsBySource[DAMAGE_BULLET], killsBySource[DAMAGE_AREA]);
+            ImGui::Text("Damage: %d events on %d mobs", damageQueue.eventCount, damageQueue.targetCount);
+            ImGui::Text("XP: %llu, gems %d (%d attracted, %d merged), %.3f ms", (unsigned long long)playerXp, gems.count,
+                        (int)gems.active.size(), gems.merges, gems.updateMs);
+            ImGui::SliderFloat("Magnet Radius", &gems.magnetRadius, 20.0f, 600.0f);
+            ImGui::SliderInt("Gem Merge Cap", &gems.mergeCap, 256, 60000);
+            ImGui::Text("Mob Grid: %dx%d cells, %d mobs, %d homing", mobGrid.cols, mobGrid.rows,
+                        (int)mobCenters.size(), (int)homingIds.size());
+            if (ImGui::SliderFloat("Fire Rate (shots/s)", &playerStats.base[STAT_FIRE_RATE], 0.5f, 20.0f)) playerStats.dirty = true;
+            if (ImGui::SliderFloat("Bullet Speed", &playerStats.base[STAT_BULLET_SPEED], 100.0f, 1200.0f)) playerStats.dirty = true;
+            ImGui::Text("Stats: fire %.2f/s, speed %.0f, dmg %d, move %.0f", statValue(playerStats, STAT_FIRE_RATE),
+                        statValue(playerStats, STAT_BULLET_SPEED), player.dmg, player.speed);
+            ImGui::Text("Modifiers: %d active, %d recomputes", (int)playerStats.mods.size(), playerStats.recomputes);
+            ImGui::Separator();
+            ImGui::Text("Mob Types: %d", (int)archetypes.size());
+            ImGui::Text("Wave Mods: +%d hp, +%d dmg, +%d size", waveMods.hp, waveMods.dmg, int(waveMods.size));
+            ImGui::Text("Enemies: %zu", enemyCount());
+            if (ImGui::Checkbox("Compact Mob Storage", &compactMobs)) {
+                if (compactMobs) { packMobs(enemies, compactArchetypes, compactEnemies); enemies.clear(); }
+                else { unpackMobs(compactEnemies, compactArchetypes, enemies); compactEnemies.clear(); }
+                for (Bullet& b : bullets) b.hits = BulletHits();
+            }
+            ImGui::Text("Visible: mobs %d/%d, bullets %d/%d, buffs %d/%d",
+                        (int)visible.indices[CULL_MOBS].size(), visible.total[CULL_MOBS],
+                        (int)visible.indices[CULL_BULLETS].size(), visible.total[CULL_BULLETS],
+                        (int)visible.indices[CULL_BUFFS].size(), visible.total[CULL_BUFFS]);
+            ImGui::Text("Bytes/mob: %zu (%d archetypes)", compactMobs ? sizeof(CompactMob) : sizeof(Mob), (int)compactArchetypes.size());
+            ImGui::Text("Wave Key: %d/%d  Spawn Queue: %d", director.current + 1, (int)director.timeline.size(), director.queued);
+            ImGui::Text("Spawned: %d in %.0f us", director.spawnedLastFrame, director.spentUsLastFrame);
+            ImGui::SliderFloat("Spawn Rate Scale", &director.rateScale, 0.1f, 10.0f);
+            ImGui::SliderFloat("Spawn Budget (us)", &director.budgetUs, 20.0f, 4000.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+            ImGui::SliderFloat("Enemy Speed Scale", &enemySpeedScale, 0.1f, 5.0f);
+            ImGui::Text("Camera: %.0f, %.0f  Chunks: %d active, %d coarse, %d sleeping", cam.x, cam.y,
+                        chunks.chunksByState[CHUNK_ACTIVE], chunks.chunksByState[CHUNK_COARSE], chunks.chunksByState[CHUNK_SLEEP]);
+            ImGui::Checkbox("Sleep Far Chunks", &chunkSleep);
+            ImGui::SameLine();
+            ImGui::Checkbox("Show Chunks", &showChunks);
+            if (!compactMobs) {
+                ImGui::SameLine();
+                ImGui::Text("%d mobs asleep", lodStats.sleeping);
+            }
+            ImGui::Text("Walls: %d, BVH %d nodes depth %d", (int)obstacles.rects.size(), (int)obstacles.nodes.size(), obstacles.depth);
+            ImGui::Checkbox("Flow Field", &flowOn);
+            ImGui::SameLine();
+            ImGui::Text("%d rebuilds, last %.3f ms", flow.rebuilds, flow.buildMs);
+            ImGui::Checkbox("Mob LOD", &lod.enabled);
+            ImGui::SliderFloat("LOD Near Dist", &lod.nearDist, 100.0f, 2000.0f);
+            ImGui::SliderFloat("LOD Far Dist", &lod.farDist, 200.0f, 4000.0f);
+            ImGui::SliderInt("LOD Mid Period", &lod.midPeriod, 1, 8);
+            ImGui::SliderInt("LOD Far Period", &lod.farPeriod, 1, 16);
+            ImGui::Checkbox("Adaptive Steer Slices", &steer.adaptive);
+            ImGui::SliderInt("Steer Slices", &steer.slices, 1, steer.maxSlices);
+            ImGui::SliderFloat("Steer Budget (ms)", &steer.budgetMs, 0.1f, 8.0f);
+            ImGui::SliderInt("Max Enemies", &maxEnemies, 10, compactMobs ? 1000000 : 5000, "%d", ImGuiSliderFlags_Logarithmic);
+            if (ImGui::Button("Clear Enemies")) { enemies.clear(); compactEnemies.clear(); }
+            if (ImGui::Button("Clear Bullets")) bullets.clear();
+            if (ImGui::Button("Spawn 10 Enemies")) queueSpawns(director, 10, archetypes);
+            if (ImGui::Button("Spawn 1000 Enemies")) queueSpawns(director, 1000, archetypes);
+            ImGui::Checkbox("Particles", &particlesOn);
+            ImGui::SameLine();
+            ImGui::Text("%d live / %d, %.3f ms", particles.alive, particles.capacity, particles.updateMs);
+            ImGui::Checkbox("Damage Numbers", &damageNumbersOn);
+            ImGui::SameLine();
+            ImGui::Text("%d / %d, %d merged, %d quads", damageNumbers.count, damageNumbers.capacity,
+                        damageNumbers.mergedLastFrame, damageNumbers.quadsLastFrame);
+            ImGui::Text("Renderer: %s", renderer.name);
+            ImGui::Text("Atlas: %d sprites, %dx%d (%.0f%% used)", (int)atlas.uvs.size() - 1, atlas.w, atlas.h, atlas.fill * 100.0f);
+            ImGui::End();
+
+            if (useRenderThread) {
+                ImGui::Checkbox("Pace Sim To Render", &renderThread.pace);
+                profileCounter("Render thread (ms)", SDL_GetAtomicInt(&renderThread.lastRenderUs) / 1000.0);
+                profileCounter("Frames dropped", renderThread.framesDropped);
             }
+            drawProfilerWindow();
         }
-        ImGui::End();
 
-        // Render
-        glViewport(0, 0, WIN_W, WIN_H);
-        glClearColor(0.07f, 0.07f, 0.09f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        // Render snapshot
+        {
+            PROFILE_SCOPE("Snapshot");
+            RenderSnapshot& snap = useRenderThread ? renderThreadBackBuffer(renderThread) : inlineSnapshot;
+            snapshotBegin(snap, WIN_W, WIN_H, frameIndex);
+            snap.atlas = &atlas;
+            snapshotSetOrigin(snap, cam.x, cam.y);
+
+            // podea in carouri, altfel nu se vede ca se misca camera; cu Show Chunks ia culoarea chunk-ului
+            {
+                const float tile = 256.0f;
+                int tx0 = (int)(view.x / tile), tx1 = (int)((view.x + view.w) / tile);
+                int ty0 = (int)(view.y / tile), ty1 = (int)((view.y + view.h) / tile);
+                static const SDL_Color stateTint[CHUNK_STATE_COUNT] = { { 22, 34, 24, 255 }, { 34, 30, 20, 255 }, { 34, 20, 22, 255 } };
+                for (int ty = ty0; ty <= ty1; ++ty) {
+                    for (int tx = tx0; tx <= tx1; ++tx) {
+                        if (((tx + ty) & 1) && !showChunks) continue;
+                        SDL_FRect r{ tx * tile, ty * tile, tile, tile };
+                        SDL_Color c{ 24, 24, 30, 255 };
+                        if (showChunks) {
+                            c = stateTint[chunkStateAt(chunks, r.x + 1.0f, r.y + 1.0f)];
+                            if ((tx + ty) & 1) { c.r -= 4; c.g -= 4; c.b -= 4; }
+                        }
+                        snapshotAddRect(snap, r, c);
+                    }
+                }
+            }
+
+            for (Uint32 i : visibleWalls) snapshotAddRect(snap, obstacles.rects[i], { 70, 70, 84, 255 });
 
-        glMatrixMode(GL_PROJECTION);
-        glLoadIdentity();
-        glOrtho(0.0, WIN_W, WIN_H, 0.0, -1.0, 1.0);
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
+            xpGemsToSnapshot(gems, snap, view, gemSprite); // sub tot restul
+            snapshotAddRect(snap, player.rect, player.color, playerSprite);
 
-        drawRectGL(player.rect, player.color);
+            if (compactMobs) {
+                snapshotAddRectsIndexed(snap, mobRects.data(), mobColors.data(), mobSprites.data(), visible.indices[CULL_MOBS]);
+            }
+            else {
+                for (Uint32 i : visible.indices[CULL_MOBS]) {
+                    const Mob& m = enemies[i];
+                    snapshotAddRect(snap, m.rect, m.color, m.type < mobTypeSprites.size() ? mobTypeSprites[m.type] : SPRITE_NONE);
+                }
+            }
 
-        for (auto& en : enemies) drawRectGL(en.rect, en.color);
+            for (Uint32 i : visible.indices[CULL_BULLETS]) snapshotAddRect(snap, bullets[i].rect, bullets[i].color, bulletSprite);
 
-        for (auto& b : bullets) drawRectGL(b.rect, b.color);
+            particlesToSnapshot(particles, snap, view);
 
-        for (auto& buff : buffs) {
-            if (buff.alive) drawRectGL(buff.rect, buff.color);
+            buffsToSnapshot(buffs, snap, visible.indices[CULL_BUFFS], buffSprite);
+
+            // UI - ImGui
+            ImGui::Render();
+            ImDrawData* drawData = ImGui::GetDrawData();
+            snapshotCopyImGui(snap, drawData, !useRenderThread || imguiTexturesPending(drawData));
         }
 
-        // UI - ImGui
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        if (useRenderThread) renderThreadPublish(renderThread);
+        else {
+            Uint64 r0 = SDL_GetPerformanceCounter();
+            rendererDrawSnapshot(renderer, inlineSnapshot);
+            double renderMs = (SDL_GetPerformanceCounter() - r0) * 1000.0 / perfFreq;
+            profileCounter("Render (ms)", renderMs);
+            renderMsTotal += renderMs;
+        }
+        if (headless && frameIndex + 1 >= (Uint32)headlessFrames) running = false;
 
-        SDL_GL_SwapWindow(window);
+        profileEndFrame();
+        ++frameIndex;
 
 		// verificare daca jucatorul a murit
         if (player.hp <= 0) {
             player.hp = 100;
 			player.color = { 200, 200, 60, 255 };
-            player.rect.x = WIN_W * 0.5f - 16.0f;
-            player.rect.y = WIN_H * 0.5f - 16.0f;
+            player.rect.x = WORLD_W * 0.5f - 16.0f;
+            player.rect.y = WORLD_H * 0.5f - 16.0f;
+            cam.x = WORLD_W * 0.5f - cam.w * 0.5f;
+            cam.y = WORLD_H * 0.5f - cam.h * 0.5f;
             enemies.clear();
+            compactEnemies.clear();
             bullets.clear();
+            clearParticles(particles);
+            clearDamageNumbers(damageNumbers);
+            kills = 0;
+            clearXpGems(gems);
+            playerXp = 0;
+            killsBySource[DAMAGE_BULLET] = killsBySource[DAMAGE_AREA] = 0;
+            // valurile o iau de la capat, cu ceasul jocului
+            startTime = SDL_GetTicks();
+            simTime = 0.0;
+            lastSpawnSecond = -1;
+            lastSpawnSecondEn = -1;
+            waveMods = WaveModifiers();
+            rebuildArchetypes();
+            resetWaveDirector(director);
+        }
+    }
+
+    int exitCode = 0;
+    if (headless) {
+        printf("headless: %u frames, seed %u, %zu enemies, player hp %d, render %.3f ms/frame (%d workers)\n",
+               frameIndex, seed, enemyCount(), player.hp, frameIndex ? renderMsTotal / frameIndex : 0.0, jobsWorkerCount());
+        if (dumpPath && softSaveImage(softRenderer, dumpPath)) printf("wrote %s\n", dumpPath);
+        if (goldenPath) {
+            GoldenResult g = softCompareGolden(softRenderer, goldenPath, goldenTolerance);
+            if (!g.loaded || g.mismatched > 0) exitCode = 1;
+            if (g.loaded) {
+                printf("golden %s: %s, %d pixels over tolerance %d (%.3f%%), max diff %d\n", goldenPath,
+                       g.mismatched ? "MISMATCH" : "ok", g.mismatched, goldenTolerance, g.mismatchFraction * 100.0f, g.maxDiff);
+            }
         }
     }
 
     // cleanup
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplSDL3_Shutdown();
+    if (useRenderThread) stopRenderThread(renderThread);
+    else renderer.shutdown(renderer.self);
+    snapshotFree(inlineSnapshot);
+    if (!headless) ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
+    jobsShutdown();
 
-    SDL_GL_DestroyContext(gl_context);
-    SDL_DestroyWindow(window);
+    if (gl_context) SDL_GL_DestroyContext(gl_context);
+    if (window) SDL_DestroyWindow(window);
     SDL_Quit();
 
-    return 0;
+    return exitCode;
 }
@@ -0,0 +1,117 @@
+#include "mob_archetypes.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+static const int MOB_COLUMNS = 10;
+
+static MobArchetype defaultArchetype() {
+    MobArchetype a;
+    SDL_strlcpy(a.name, "grunt", sizeof(a.name));
+    a.hp = 10;
+    a.dmg = 5;
+    a.size = 24.0f;
+    a.speed = 80.0f;
+    a.color = { 200, 80, 80, 255 };
+    a.behavior = MOB_BEHAVIOR_CHASE;
+    a.weight = 1.0f;
+    return a;
+}
+
+int splitTokens(char* line, char** tokens, int maxTokens) {
+    int n = 0;
+    char* p = line;
+    while (*p && n < maxTokens) {
+        while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+        if (!*p) break;
+        tokens[n++] = p;
+        while (*p && *p != ' ' && *p != '\t' && *p != '\r') ++p;
+        if (*p) *p++ = '\0';
+    }
+    return n;
+}
+
+static Uint8 toByte(const char* s) {
+    return (Uint8)std::max(0, std::min(255, SDL_atoi(s)));
+}
+
+bool parseMobArchetypes(const char* path, char* data, std::vector<MobArchetype>& out) {
+    out.clear();
+    if (data) {
+        int lineNo = 0;
+        char* line = data;
+        while (line && *line) {
+            char* next = SDL_strchr(line, '\n');
+            if (next) *next++ = '\0';
+            ++lineNo;
+
+            char* tok[MOB_COLUMNS];
+            int n = splitTokens(line, tok, MOB_COLUMNS);
+            if (n > 0 && tok[0][0] != '#') {
+                if (n < MOB_COLUMNS || out.size() >= 256) {
+                    printf("%s:%d: skipped (expected name hp dmg size speed r g b behavior weight)\n", path, lineNo);
+                }
+                else {
+                    MobArchetype a;
+                    SDL_strlcpy(a.name, tok[0], sizeof(a.name));
+                    a.hp = SDL_atoi(tok[1]);
+                    a.dmg = SDL_atoi(tok[2]);
+                    a.size = (float)SDL_atof(tok[3]);
+                    a.speed = (float)SDL_atof(tok[4]);
+                    a.color = { toByte(tok[5]), toByte(tok[6]), toByte(tok[7]), 255 };
+                    a.behavior = toByte(tok[8]);
+                    a.weight = std::max(0.0f, (float)SDL_atof(tok[9]));
+                    out.push_back(a);
+                }
+            }
+            line = next;
+        }
+    }
+
+    if (out.empty()) {
+        printf("No mob archetypes loaded from %s, using built-in grunt\n", path);
+        out.push_back(defaultArchetype());
+        return false;
+    }
+    return true;
+}
+
+void applyWaveModifiers(const std::vector<MobArchetype>& base, const WaveModifiers& mods,
+                        std::vector<MobArchetype>& scaled) {
+    scaled = base;
+    for (MobArchetype& a : scaled) {
+        a.hp += mods.hp;
+        a.dmg += mods.dmg;
+        a.size = std::min(MAX_MOB_SIZE, a.size + mods.size);
+        a.speed *= mods.speedMul;
+    }
+}
+
+void buildSpawnTemplates(const std::vector<MobArchetype>& scaled, std::vector<Mob>& templates) {
+    templates.resize(scaled.size());
+    for (size_t i = 0; i < scaled.size(); ++i) {
+        const MobArchetype& a = scaled[i];
+        Mob& m = templates[i];
+        m.rect = { 0.0f, 0.0f, a.size, a.size };
+        m.color = a.color;
+        m.velocity = { 0.0f, 0.0f };
+        m.alive = true;
+        m.hp = a.hp;
+        m.dmg = a.dmg;
+        m.speed = a.speed;
+        m.type = (Uint8)i;
+    }
+}
+
+int pickMobArchetype(const std::vector<MobArchetype>& table) {
+    float total = 0.0f;
+    for (const MobArchetype& a : table) total += a.weight;
+    if (total <= 0.0f) return 0;
+    float r = (std::rand() / (float)RAND_MAX) * total;
+    for (size_t i = 0; i < table.size(); ++i) {
+        r -= table[i].weight;
+        if (r <= 0.0f) return (int)i;
+    }
+    return (int)table.size() - 1;
+}
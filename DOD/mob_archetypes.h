@@ -0,0 +1,47 @@
+#pragma once
+
+#include "entities.h"
+
+#include <vector>
+
+enum MobBehavior : Uint8 {
+    MOB_BEHAVIOR_CHASE = 0,
+};
+
+// One row of data/mobs.txt
+struct MobArchetype {
+    char name[32];
+    int hp;
+    int dmg;
+    float size;
+    float speed;
+    SDL_Color color;
+    Uint8 behavior;
+    float weight; // relative spawn chance
+};
+
+// Wave scaling, applied to the whole table instead of to each spawned mob
+struct WaveModifiers {
+    int hp = 0;
+    int dmg = 0;
+    float size = 0.0f;
+    float speedMul = 1.0f;
+};
+
+static const float MAX_MOB_SIZE = 200.0f;
+
+// Parses the archetype table from text already in memory (modified in place, may be nullptr);
+// path is only for messages. Falls back to a single built-in grunt if the text is missing or empty.
+bool parseMobArchetypes(const char* path, char* text, std::vector<MobArchetype>& out);
+
+void applyWaveModifiers(const std::vector<MobArchetype>& base, const WaveModifiers& mods,
+                        std::vector<MobArchetype>& scaled);
+
+// Prebuilt mobs, one per archetype. Spawning copies one of these and only fills in position/velocity.
+void buildSpawnTemplates(const std::vector<MobArchetype>& scaled, std::vector<Mob>& templates);
+
+// splits a text line in place on whitespace, returns the token count
+int splitTokens(char* line, char** tokens, int maxTokens);
+
+// weighted random pick, returns an archetype index
+int pickMobArchetype(const std::vector<MobArchetype>& table);
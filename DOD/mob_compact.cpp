@@ -0,0 +1,188 @@
+#include "mob_compact.h"
+
+#include "jobs.h"
+#include "sprite_atlas.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static bool sameColor(const SDL_Color& a, const SDL_Color& b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+int findOrAddArchetype(std::vector<CompactArchetype>& table, const CompactArchetype& a) {
+    for (size_t i = 0; i < table.size(); ++i) {
+        const CompactArchetype& t = table[i];
+        if (t.size == a.size && t.dmg == a.dmg && t.speed == a.speed && t.type == a.type && sameColor(t.color, a.color)) return (int)i;
+    }
+    if (table.size() >= (size_t)MAX_MOB_ARCHETYPES) return -1;
+    table.push_back(a);
+    return (int)table.size() - 1;
+}
+
+int nearestArchetype(const std::vector<CompactArchetype>& table, const CompactArchetype& a) {
+    int best = 0;
+    float bestScore = FLT_MAX;
+    for (size_t i = 0; i < table.size(); ++i) {
+        const CompactArchetype& t = table[i];
+        float score = std::fabs(t.size - a.size) + std::fabs(t.speed - a.speed) + (float)std::abs(t.dmg - a.dmg);
+        if (t.type != a.type) score += 1e6f;
+        if (score < bestScore) {
+            bestScore = score;
+            best = (int)i;
+        }
+    }
+    return best;
+}
+
+int pruneArchetypes(std::vector<CompactArchetype>& table, std::vector<CompactMob>& mobs) {
+    bool used[MAX_MOB_ARCHETYPES] = {};
+    for (const CompactMob& m : mobs) used[m.archetype] = true;
+    Uint8 remap[MAX_MOB_ARCHETYPES];
+    size_t dst = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+        if (!used[i]) continue;
+        remap[i] = (Uint8)dst;
+        table[dst++] = table[i];
+    }
+    int removed = (int)(table.size() - dst);
+    table.resize(dst);
+    if (removed > 0) {
+        for (CompactMob& m : mobs) m.archetype = remap[m.archetype];
+    }
+    return removed;
+}
+
+CompactMob packMob(const Mob& m, Uint8 archetype) {
+    CompactMob c;
+    c.x = toFixed(m.rect.x);
+    c.y = toFixed(m.rect.y);
+    c.hp = (Sint16)std::max(-32768, std::min(32767, m.hp));
+    c.archetype = archetype;
+    c.flags = m.alive ? COMPACT_MOB_ALIVE : 0;
+    return c;
+}
+
+Mob unpackMob(const CompactMob& c, const CompactArchetype& a) {
+    Mob m;
+    m.rect = { fromFixed(c.x), fromFixed(c.y), a.size, a.size };
+    m.color = a.color;
+    m.velocity = { 0, 0 };
+    m.alive = (c.flags & COMPACT_MOB_ALIVE) != 0;
+    m.hp = c.hp;
+    m.dmg = a.dmg;
+    m.speed = a.speed;
+    m.type = a.type;
+    return m;
+}
+
+void packMobs(const std::vector<Mob>& src, std::vector<CompactArchetype>& table, std::vector<CompactMob>& dst) {
+    dst.clear();
+    dst.reserve(src.size());
+    int approximated = 0;
+    for (const Mob& m : src) {
+        CompactArchetype a{ m.rect.w, m.color, m.dmg, m.speed, m.type };
+        int arch = findOrAddArchetype(table, a);
+        if (arch < 0) {
+            arch = nearestArchetype(table, a);
+            ++approximated;
+        }
+        dst.push_back(packMob(m, (Uint8)arch));
+    }
+    if (approximated > 0) {
+        printf("Compact archetype table full (%d rows), %d mobs packed with the closest row\n", MAX_MOB_ARCHETYPES, approximated);
+    }
+}
+
+void unpackMobs(const std::vector<CompactMob>& src, const std::vector<CompactArchetype>& table, std::vector<Mob>& dst) {
+    dst.clear();
+    dst.reserve(src.size());
+    for (const CompactMob& c : src) dst.push_back(unpackMob(c, table[c.archetype]));
+}
+
+void updateCompactMobs(std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                       Vec2 target, float speedScale, float dt, const WorldChunks* chunks,
+                       const FlowField* flow) {
+    for (CompactMob& m : mobs) {
+        const CompactArchetype& a = table[m.archetype];
+        float half = a.size * 0.5f;
+        float cx = fromFixed(m.x) + half, cy = fromFixed(m.y) + half;
+        if (chunks && chunkStateAt(*chunks, cx, cy) == CHUNK_SLEEP) continue;
+        float step = a.speed * speedScale * dt;
+        Vec2 dir = flow ? flowDirection(*flow, cx, cy) : Vec2{ 0.0f, 0.0f };
+        if (dir.x == 0.0f && dir.y == 0.0f) dir = normalize({ target.x - cx, target.y - cy });
+        m.x += toFixed(dir.x * step);
+        m.y += toFixed(dir.y * step);
+    }
+}
+
+void collideCompactMobsWithObstacles(std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                                     Obstacles& o) {
+    if (o.nodes.empty() || mobs.empty()) return;
+    const int grain = 512;
+    obstaclesBeginChunks(o, (int)mobs.size() / grain + 1);
+    parallelFor((int)mobs.size(), grain, [&](int begin, int end) {
+        ObstacleStats& stats = o.chunkStats[begin / grain];
+        for (int i = begin; i < end; ++i) {
+            CompactMob& m = mobs[i];
+            if (!(m.flags & COMPACT_MOB_ALIVE)) continue;
+            float size = table[m.archetype].size;
+            SDL_FRect r{ fromFixed(m.x), fromFixed(m.y), size, size };
+            if (!obstaclePushOut(o, r, stats)) continue;
+            m.x = toFixed(r.x);
+            m.y = toFixed(r.y);
+        }
+    });
+    obstaclesEndChunks(o);
+}
+
+int collidePlayerCompact(std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                         const SDL_FRect& player, int& outDamage, const CombatFx& fx) {
+    int hits = 0;
+    for (CompactMob& m : mobs) {
+        if (!(m.flags & COMPACT_MOB_ALIVE)) continue;
+        const CompactArchetype& a = table[m.archetype];
+        SDL_FRect r{ fromFixed(m.x), fromFixed(m.y), a.size, a.size };
+        if (aabb(r, player)) {
+            m.flags &= (Uint8)~COMPACT_MOB_ALIVE;
+            fxMobDeath(fx, r, a.color);
+            outDamage += a.dmg;
+            ++hits;
+        }
+    }
+    return hits;
+}
+
+void removeDeadCompact(std::vector<CompactMob>& mobs) {
+    size_t dst = 0;
+    for (size_t i = 0; i < mobs.size(); ++i) {
+        if (mobs[i].flags & COMPACT_MOB_ALIVE) {
+            if (dst != i) mobs[dst] = mobs[i];
+            ++dst;
+        }
+    }
+    mobs.resize(dst);
+}
+
+void compactToRects(const std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                    const std::vector<Uint16>& typeSprites, std::vector<SDL_FRect>& rects,
+                    std::vector<SDL_Color>& colors, std::vector<Uint16>& sprites) {
+    rects.resize(mobs.size());
+    colors.resize(mobs.size());
+    sprites.resize(mobs.size());
+    size_t n = 0;
+    for (const CompactMob& m : mobs) {
+        if (!(m.flags & COMPACT_MOB_ALIVE)) continue;
+        const CompactArchetype& a = table[m.archetype];
+        rects[n] = { fromFixed(m.x), fromFixed(m.y), a.size, a.size };
+        colors[n] = a.color;
+        sprites[n] = a.type < typeSprites.size() ? typeSprites[a.type] : SPRITE_NONE;
+        ++n;
+    }
+    rects.resize(n);
+    colors.resize(n);
+    sprites.resize(n);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "entities.h"
+#include "combat_fx.h"
+#include "world.h"
+#include "flow_field.h"
+#include "obstacles.h"
+
+#include <vector>
+
+// Shared per-type mob data. Compact mobs only store an index into this table.
+struct CompactArchetype {
+    float size;
+    SDL_Color color;
+    int dmg;
+    float speed;
+    Uint8 type; // index in the MobArchetype table
+};
+
+enum : Uint8 {
+    COMPACT_MOB_ALIVE = 1 << 0,
+};
+
+// Compact horde storage, 12 bytes per mob instead of sizeof(Mob).
+// Position is 16.16 fixed point, size/color/dmg/speed live in the archetype table and
+// velocity is not stored at all since mobs re-steer towards the player every frame.
+struct CompactMob {
+    Sint32 x, y;
+    Sint16 hp;
+    Uint8 archetype;
+    Uint8 flags;
+};
+static_assert(sizeof(CompactMob) < 16, "CompactMob must stay under 16 bytes");
+
+static const int MAX_MOB_ARCHETYPES = 256;
+
+static inline Sint32 toFixed(float v) { return (Sint32)(v * 65536.0f); }
+static inline float fromFixed(Sint32 v) { return (float)v * (1.0f / 65536.0f); }
+
+// returns the index of an identical archetype, appends a new one otherwise (-1 if the table is full)
+int findOrAddArchetype(std::vector<CompactArchetype>& table, const CompactArchetype& a);
+// closest row to a, preferring the same type; for when the table is full
+int nearestArchetype(const std::vector<CompactArchetype>& table, const CompactArchetype& a);
+// Drops the rows no mob (alive or not) points at and renumbers the mobs. Wave scaling adds a
+// row per type every step, so this runs before the new rows are added.
+int pruneArchetypes(std::vector<CompactArchetype>& table, std::vector<CompactMob>& mobs);
+
+CompactMob packMob(const Mob& m, Uint8 archetype);
+Mob unpackMob(const CompactMob& c, const CompactArchetype& a);
+
+// conversions between the two storage modes (used when toggling compact mode)
+void packMobs(const std::vector<Mob>& src, std::vector<CompactArchetype>& table, std::vector<CompactMob>& dst);
+void unpackMobs(const std::vector<CompactMob>& src, const std::vector<CompactArchetype>& table, std::vector<Mob>& dst);
+
+// steer towards target (along the flow field if given) and integrate, positions stay in fixed
+// point; mobs in sleeping chunks are left where they are
+void updateCompactMobs(std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                       Vec2 target, float speedScale, float dt, const WorldChunks* chunks = nullptr,
+                       const FlowField* flow = nullptr);
+
+// pushes live mobs out of the walls, in parallel; stats go to o.stats
+void collideCompactMobsWithObstacles(std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                                     Obstacles& o);
+
+// kills every mob touching the player, returns the number of hits and adds their damage to outDamage
+int collidePlayerCompact(std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                         const SDL_FRect& player, int& outDamage, const CombatFx& fx = CombatFx());
+
+void removeDeadCompact(std::vector<CompactMob>& mobs);
+
+// conversion kernel to the render format (one rect + color + sprite per live mob),
+// typeSprites maps CompactArchetype::type to an atlas sprite
+void compactToRects(const std::vector<CompactMob>& mobs, const std::vector<CompactArchetype>& table,
+                    const std::vector<Uint16>& typeSprites, std::vector<SDL_FRect>& rects,
+                    std::vector<SDL_Color>& colors, std::vector<Uint16>& sprites);
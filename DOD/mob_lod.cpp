@@ -0,0 +1,79 @@
+#include "mob_lod.h"
+
+#include <algorithm>
+
+void updateMobsLod(std::vector<Mob>& mobs, Vec2 target, float speedScale, float dt, Uint32 frame,
+                   const SDL_FRect& view, const LodSettings& lod, const SteerSlicing& steer, LodStats& stats,
+                   const WorldChunks* chunks, const FlowField* flow) {
+    const int periods[LOD_TIER_COUNT] = { 1, std::max(1, lod.midPeriod), std::max(1, lod.farPeriod) };
+    const float nearSq = lod.nearDist * lod.nearDist;
+    const float farSq = lod.farDist * lod.farDist;
+
+    for (int t = 0; t < LOD_TIER_COUNT; ++t) stats.tierCount[t] = 0;
+    stats.updated = 0;
+    stats.skipped = 0;
+    stats.retargeted = 0;
+    stats.sleeping = 0;
+    const Uint32 slices = (Uint32)std::max(1, steer.slices);
+
+    auto updateMob = [&](Mob& m, bool coarse) {
+        if (coarse) m.lodTier = LOD_FAR;
+        int period = lod.enabled || coarse ? periods[m.lodTier] : 1;
+        stats.tierCount[m.lodTier]++;
+        if ((frame + m.lodBucket) % (Uint32)period != 0) {
+            stats.skipped++;
+            return;
+        }
+        stats.updated++;
+
+        float step = dt * (float)period;
+        if (period == 1 && (frame + m.lodBucket) % slices != 0) {
+            // between re-targets keep the last heading
+            m.rect.x += m.velocity.x * step;
+            m.rect.y += m.velocity.y * step;
+            return;
+        }
+        stats.retargeted++;
+
+        // urmarirea playerului de catre mobi
+        Vec2 center{ m.rect.x + m.rect.w * 0.5f, m.rect.y + m.rect.h * 0.5f };
+        Vec2 toPlayer{ target.x - center.x, target.y - center.y };
+        float distSq = toPlayer.x * toPlayer.x + toPlayer.y * toPlayer.y;
+        Vec2 dir = flow ? flowDirection(*flow, center.x, center.y) : Vec2{ 0.0f, 0.0f };
+        if (dir.x == 0.0f && dir.y == 0.0f) dir = normalize(toPlayer);
+        m.velocity.x = dir.x * m.speed * speedScale;
+        m.velocity.y = dir.y * m.speed * speedScale;
+
+        m.rect.x += m.velocity.x * step;
+        m.rect.y += m.velocity.y * step;
+
+        bool onScreen = m.rect.x + m.rect.w > view.x && m.rect.x < view.x + view.w &&
+                        m.rect.y + m.rect.h > view.y && m.rect.y < view.y + view.h;
+        if (distSq > farSq) m.lodTier = LOD_FAR;
+        else if (distSq > nearSq || !onScreen) m.lodTier = LOD_MID;
+        else m.lodTier = LOD_NEAR;
+    };
+
+    // buckets from another frame (or another mob array) would index out of range
+    if (!chunks || chunks->bucketStart.empty() || chunks->bucketStart.back() != mobs.size()) {
+        for (Mob& m : mobs) updateMob(m, false);
+        return;
+    }
+    for (size_t c = 0; c < chunks->state.size(); ++c) {
+        Uint8 st = chunks->state[c];
+        if (st == CHUNK_SLEEP) continue;
+        for (Uint32 k = chunks->bucketStart[c]; k < chunks->bucketStart[c + 1]; ++k) {
+            updateMob(mobs[chunks->bucketItems[k]], st == CHUNK_COARSE);
+        }
+    }
+    stats.sleeping = chunks->itemsByState[CHUNK_SLEEP];
+}
+
+void adaptSteerSlices(SteerSlicing& steer, float measuredMs) {
+    if (!steer.adaptive) return;
+    // only step once every half second or so, otherwise K oscillates with frame noise
+    if (++steer.framesSinceAdapt < 30) return;
+    steer.framesSinceAdapt = 0;
+    if (measuredMs > steer.budgetMs && steer.slices < steer.maxSlices) steer.slices++;
+    else if (measuredMs < steer.budgetMs * 0.5f && steer.slices > 1) steer.slices--;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "entities.h"
+#include "world.h"
+#include "flow_field.h"
+
+#include <vector>
+
+enum MobLodTier : Uint8 {
+    LOD_NEAR = 0, // on screen and close: every frame
+    LOD_MID,      // off screen or past nearDist: every midPeriod frames
+    LOD_FAR,      // past farDist: every farPeriod frames
+    LOD_TIER_COUNT
+};
+
+struct LodSettings {
+    bool enabled = true;
+    float nearDist = 700.0f;
+    float farDist = 1400.0f;
+    int midPeriod = 2;
+    int farPeriod = 4;
+};
+
+// Near mobs integrate every frame but only re-target the player every `slices` frames.
+// With `adaptive` the slice count follows the measured cost of the mob update.
+struct SteerSlicing {
+    int slices = 1;
+    bool adaptive = true;
+    float budgetMs = 1.0f;
+    int maxSlices = 8;
+    int framesSinceAdapt = 0;
+};
+
+struct LodStats {
+    int tierCount[LOD_TIER_COUNT];
+    int updated;
+    int skipped;
+    int retargeted;
+    int sleeping; // in sleeping chunks, not visited at all
+};
+
+// Steer and integrate. Reduced tiers only run on frames matching their bucket and then
+// integrate with dt * period, so on average they cover the same distance. Reduced tiers
+// always re-target when they run, near mobs follow the steering slices.
+// With chunks (bucketed over mobs this frame) only awake buckets are walked; mobs in coarse
+// chunks run at the far rate. Buckets that do not cover mobs.size() are ignored. With a flow
+// field (built towards target) re-targeting follows it around walls.
+void updateMobsLod(std::vector<Mob>& mobs, Vec2 target, float speedScale, float dt, Uint32 frame,
+                   const SDL_FRect& view, const LodSettings& lod, const SteerSlicing& steer, LodStats& stats,
+                   const WorldChunks* chunks = nullptr, const FlowField* flow = nullptr);
+
+// grows/shrinks the slice count from the last measured update cost
+void adaptSteerSlices(SteerSlicing& steer, float measuredMs);
@@ -0,0 +1,289 @@
+#include "obstacles.h"
+
+#include "jobs.h"
+#include "mob_archetypes.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+
+static const Uint32 BVH_LEAF_SIZE = 4;
+static const int BVH_STACK = 64;
+
+bool parseLevel(const char* path, char* data, float worldW, float worldH, std::vector<SDL_FRect>& out) {
+    out.clear();
+    if (!data) {
+        printf("No level loaded from %s, the world is empty\n", path);
+        return false;
+    }
+
+    std::vector<SDL_FRect> scattered;
+    std::vector<SDL_FRect> clear;
+    int lineNo = 0;
+    char* line = data;
+    while (line && *line) {
+        char* next = SDL_strchr(line, '\n');
+        if (next) *next++ = '\0';
+        ++lineNo;
+
+        char* tok[6];
+        int n = splitTokens(line, tok, 6);
+        if (n > 0 && tok[0][0] != '#') {
+            float v[5] = {};
+            for (int i = 1; i < n; ++i) v[i - 1] = (float)SDL_atof(tok[i]);
+            if (SDL_strcmp(tok[0], "wall") == 0 && n == 5) {
+                out.push_back({ v[0], v[1], v[2], v[3] });
+            }
+            else if (SDL_strcmp(tok[0], "pillar") == 0 && n == 4) {
+                out.push_back({ v[0] - v[2] * 0.5f, v[1] - v[2] * 0.5f, v[2], v[2] });
+            }
+            else if (SDL_strcmp(tok[0], "scatter") == 0 && n == 5) {
+                Uint64 state = (Uint64)v[1];
+                for (int i = 0; i < (int)v[0]; ++i) {
+                    float size = v[2] + SDL_randf_r(&state) * (v[3] - v[2]);
+                    float x = SDL_randf_r(&state) * (worldW - size);
+                    float y = SDL_randf_r(&state) * (worldH - size);
+                    scattered.push_back({ x, y, size, size });
+                }
+            }
+            else if (SDL_strcmp(tok[0], "clear") == 0 && n == 5) {
+                clear.push_back({ v[0], v[1], v[2], v[3] });
+            }
+            else {
+                printf("%s:%d: skipped (expected wall x y w h | pillar cx cy size | scatter count seed min max | clear x y w h)\n",
+                       path, lineNo);
+            }
+        }
+        line = next;
+    }
+
+    for (const SDL_FRect& r : scattered) {
+        bool keep = true;
+        for (const SDL_FRect& c : clear) keep = keep && !aabb(r, c);
+        if (keep) out.push_back(r);
+    }
+    return true;
+}
+
+static Uint32 buildNode(Obstacles& o, Uint32 first, Uint32 count, int depth) {
+    Uint32 index = (Uint32)o.nodes.size();
+    o.nodes.push_back(BvhNode());
+    o.depth = std::max(o.depth, depth);
+
+    BvhNode node{ FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, first, count };
+    float cMinX = FLT_MAX, cMinY = FLT_MAX, cMaxX = -FLT_MAX, cMaxY = -FLT_MAX;
+    for (Uint32 i = first; i < first + count; ++i) {
+        const SDL_FRect& r = o.rects[i];
+        node.minX = std::min(node.minX, r.x);
+        node.minY = std::min(node.minY, r.y);
+        node.maxX = std::max(node.maxX, r.x + r.w);
+        node.maxY = std::max(node.maxY, r.y + r.h);
+        cMinX = std::min(cMinX, r.x + r.w * 0.5f);
+        cMinY = std::min(cMinY, r.y + r.h * 0.5f);
+        cMaxX = std::max(cMaxX, r.x + r.w * 0.5f);
+        cMaxY = std::max(cMaxY, r.y + r.h * 0.5f);
+    }
+
+    if (count > BVH_LEAF_SIZE && depth < BVH_STACK - 2) {
+        // median split of the centers along the longer axis
+        bool splitX = cMaxX - cMinX >= cMaxY - cMinY;
+        Uint32 mid = first + count / 2;
+        std::nth_element(o.rects.begin() + first, o.rects.begin() + mid, o.rects.begin() + first + count,
+                         [splitX](const SDL_FRect& a, const SDL_FRect& b) {
+                             return splitX ? a.x + a.w * 0.5f < b.x + b.w * 0.5f : a.y + a.h * 0.5f < b.y + b.h * 0.5f;
+                         });
+        buildNode(o, first, mid - first, depth + 1);
+        node.first = buildNode(o, mid, first + count - mid, depth + 1);
+        node.count = 0;
+    }
+    o.nodes[index] = node;
+    return index;
+}
+
+void buildObstacles(Obstacles& o, const std::vector<SDL_FRect>& rects) {
+    o.rects = rects;
+    o.nodes.clear();
+    o.depth = 0;
+    if (!o.rects.empty()) buildNode(o, 0, (Uint32)o.rects.size(), 1);
+}
+
+void obstaclesBeginFrame(Obstacles& o) {
+    o.stats = ObstacleStats{};
+}
+
+void obstaclesBeginChunks(Obstacles& o, int chunkCount) {
+    o.chunkStats.assign(chunkCount, ObstacleStats{});
+}
+
+void obstaclesEndChunks(Obstacles& o) {
+    for (const ObstacleStats& c : o.chunkStats) {
+        o.stats.rayQueries += c.rayQueries;
+        o.stats.rayHits += c.rayHits;
+        o.stats.boxQueries += c.boxQueries;
+        o.stats.pushed += c.pushed;
+        o.stats.nodesVisited += c.nodesVisited;
+    }
+}
+
+// Entry/exit of the segment through a box. axis = the slab entered last (0 x, 1 y).
+static bool raySlab(Vec2 from, Vec2 delta, float minX, float minY, float maxX, float maxY,
+                    float& tEnter, float& tExit, int& axis) {
+    tEnter = -FLT_MAX;
+    tExit = FLT_MAX;
+    axis = 0;
+    const float o[2] = { from.x, from.y }, d[2] = { delta.x, delta.y };
+    const float lo[2] = { minX, minY }, hi[2] = { maxX, maxY };
+    for (int a = 0; a < 2; ++a) {
+        if (d[a] == 0.0f) {
+            if (o[a] < lo[a] || o[a] > hi[a]) return false;
+            continue;
+        }
+        float inv = 1.0f / d[a];
+        float t0 = (lo[a] - o[a]) * inv, t1 = (hi[a] - o[a]) * inv;
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > tEnter) { tEnter = t0; axis = a; }
+        tExit = std::min(tExit, t1);
+    }
+    return tEnter <= tExit && tExit >= 0.0f && tEnter <= 1.0f;
+}
+
+bool obstacleRaycast(const Obstacles& o, Vec2 from, Vec2 delta, ObstacleHit& hit, ObstacleStats& stats) {
+    stats.rayQueries++;
+    if (o.nodes.empty()) return false;
+    hit.t = FLT_MAX;
+
+    Uint32 stack[BVH_STACK];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        Uint32 index = stack[--top];
+        const BvhNode& n = o.nodes[index];
+        stats.nodesVisited++;
+        float t0, t1;
+        int axis;
+        if (!raySlab(from, delta, n.minX, n.minY, n.maxX, n.maxY, t0, t1, axis) || t0 >= hit.t) continue;
+        if (n.count == 0) {
+            stack[top++] = n.first;
+            stack[top++] = index + 1;
+            continue;
+        }
+        for (Uint32 i = n.first; i < n.first + n.count; ++i) {
+            const SDL_FRect& r = o.rects[i];
+            if (!raySlab(from, delta, r.x, r.y, r.x + r.w, r.y + r.h, t0, t1, axis)) continue;
+            if (t0 < 0.0f) {
+                // started inside
+                hit = { 0.0f, { 0.0f, 0.0f }, i };
+            }
+            else if (t0 < hit.t) {
+                Vec2 normal{ 0.0f, 0.0f };
+                if (axis == 0) normal.x = delta.x > 0.0f ? -1.0f : 1.0f;
+                else normal.y = delta.y > 0.0f ? -1.0f : 1.0f;
+                hit = { t0, normal, i };
+            }
+        }
+    }
+    if (hit.t > 1.0f) return false;
+    stats.rayHits++;
+    return true;
+}
+
+void obstacleQueryBox(const Obstacles& o, const SDL_FRect& box, std::vector<Uint32>& out, ObstacleStats& stats) {
+    out.clear();
+    stats.boxQueries++;
+    if (o.nodes.empty()) return;
+
+    Uint32 stack[BVH_STACK];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        Uint32 index = stack[--top];
+        const BvhNode& n = o.nodes[index];
+        stats.nodesVisited++;
+        if (n.maxX <= box.x || n.minX >= box.x + box.w || n.maxY <= box.y || n.minY >= box.y + box.h) continue;
+        if (n.count == 0) {
+            stack[top++] = n.first;
+            stack[top++] = index + 1;
+            continue;
+        }
+        for (Uint32 i = n.first; i < n.first + n.count; ++i) {
+            if (aabb(o.rects[i], box)) out.push_back(i);
+        }
+    }
+}
+
+bool obstaclePushOut(const Obstacles& o, SDL_FRect& r, ObstacleStats& stats) {
+    stats.boxQueries++;
+    if (o.nodes.empty()) return false;
+
+    bool moved = false;
+    Uint32 stack[BVH_STACK];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        Uint32 index = stack[--top];
+        const BvhNode& n = o.nodes[index];
+        stats.nodesVisited++;
+        if (n.maxX <= r.x || n.minX >= r.x + r.w || n.maxY <= r.y || n.minY >= r.y + r.h) continue;
+        if (n.count == 0) {
+            stack[top++] = n.first;
+            stack[top++] = index + 1;
+            continue;
+        }
+        for (Uint32 i = n.first; i < n.first + n.count; ++i) {
+            const SDL_FRect& w = o.rects[i];
+            if (!aabb(r, w)) continue;
+            float left = r.x + r.w - w.x, right = w.x + w.w - r.x;
+            float up = r.y + r.h - w.y, down = w.y + w.h - r.y;
+            float px = left < right ? -left : right;
+            float py = up < down ? -up : down;
+            if (std::fabs(px) < std::fabs(py)) r.x += px;
+            else r.y += py;
+            moved = true;
+        }
+    }
+    if (moved) stats.pushed++;
+    return moved;
+}
+
+void collideRectsWithObstacles(Obstacles& o, SDL_FRect* first, size_t stride, size_t count) {
+    if (o.nodes.empty() || count == 0) return;
+    const int grain = 512;
+    obstaclesBeginChunks(o, (int)count / grain + 1);
+    Uint8* base = (Uint8*)first;
+    parallelFor((int)count, grain, [&](int begin, int end) {
+        ObstacleStats& stats = o.chunkStats[begin / grain];
+        for (int i = begin; i < end; ++i) obstaclePushOut(o, *(SDL_FRect*)(base + i * stride), stats);
+    });
+    obstaclesEndChunks(o);
+}
+
+void collideBulletsWithObstacles(Obstacles& o, std::vector<Bullet>& bullets, float dt) {
+    if (o.nodes.empty() || bullets.empty()) return;
+    const int grain = 256;
+    obstaclesBeginChunks(o, (int)bullets.size() / grain + 1);
+    parallelFor((int)bullets.size(), grain, [&](int begin, int end) {
+        ObstacleStats& stats = o.chunkStats[begin / grain];
+        for (int i = begin; i < end; ++i) {
+            Bullet& b = bullets[i];
+            if (!b.alive) continue;
+            Vec2 delta{ b.velocity.x * dt, b.velocity.y * dt };
+            Vec2 from{ b.rect.x + b.rect.w * 0.5f - delta.x, b.rect.y + b.rect.h * 0.5f - delta.y };
+            ObstacleHit hit;
+            if (!obstacleRaycast(o, from, delta, hit, stats)) continue;
+
+            // back off half a pixel so the next step does not start inside
+            b.rect.x = from.x + delta.x * hit.t + hit.normal.x * 0.5f - b.rect.w * 0.5f;
+            b.rect.y = from.y + delta.y * hit.t + hit.normal.y * 0.5f - b.rect.h * 0.5f;
+            if (b.bounces > 0 && (hit.normal.x != 0.0f || hit.normal.y != 0.0f)) {
+                b.bounces--;
+                if (hit.normal.x != 0.0f) b.velocity.x = -b.velocity.x;
+                else b.velocity.y = -b.velocity.y;
+            }
+            else {
+                b.alive = false;
+            }
+        }
+    });
+    obstaclesEndChunks(o);
+}
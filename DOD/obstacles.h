@@ -0,0 +1,68 @@
+#pragma once
+
+#include "entities.h"
+
+#include <vector>
+
+// Static level geometry (walls, pillars) in a bounding volume hierarchy built once at load.
+// Nodes are stored depth first: the left child of an interior node is the next node, the right
+// one is at `first`. Leaves own rects[first, first + count), the rects are reordered at build.
+struct BvhNode {
+    float minX, minY, maxX, maxY;
+    Uint32 first;
+    Uint32 count; // 0 = interior
+};
+
+struct ObstacleStats {
+    int rayQueries;
+    int rayHits;
+    int boxQueries;
+    int pushed;
+    int nodesVisited;
+};
+
+struct Obstacles {
+    std::vector<SDL_FRect> rects;
+    std::vector<BvhNode> nodes;
+    int depth = 0;
+
+    // summed over the frame, reset by obstaclesBeginFrame
+    ObstacleStats stats{};
+    // per parallelFor chunk, summed by obstaclesEndChunks
+    std::vector<ObstacleStats> chunkStats;
+};
+
+struct ObstacleHit {
+    float t;     // along the ray, 0..1
+    Vec2 normal; // zero if the ray started inside
+    Uint32 obstacle;
+};
+
+// Level file: "wall x y w h", "pillar cx cy size", "scatter count seed minSize maxSize"
+// and "clear x y w h" (no scattered pillars inside). Missing file = empty level.
+bool parseLevel(const char* path, char* text, float worldW, float worldH, std::vector<SDL_FRect>& out);
+
+void buildObstacles(Obstacles& o, const std::vector<SDL_FRect>& rects);
+
+void obstaclesBeginFrame(Obstacles& o);
+void obstaclesBeginChunks(Obstacles& o, int chunkCount);
+void obstaclesEndChunks(Obstacles& o);
+
+// closest hit of the segment from + t * delta, t in [0, 1]
+bool obstacleRaycast(const Obstacles& o, Vec2 from, Vec2 delta, ObstacleHit& hit, ObstacleStats& stats);
+// indices of the obstacles overlapping box
+void obstacleQueryBox(const Obstacles& o, const SDL_FRect& box, std::vector<Uint32>& out, ObstacleStats& stats);
+// moves r out of every obstacle it overlaps along the shallower axis, true if it moved
+bool obstaclePushOut(const Obstacles& o, SDL_FRect& r, ObstacleStats& stats);
+
+// Pushes rects (read at first + i * stride, like cullRects) out of the walls, in parallel.
+void collideRectsWithObstacles(Obstacles& o, SDL_FRect* first, size_t stride, size_t count);
+
+template <typename T>
+void collideEntitiesWithObstacles(Obstacles& o, std::vector<T>& items) {
+    if (!items.empty()) collideRectsWithObstacles(o, &items[0].rect, sizeof(T), items.size());
+}
+
+// Raycasts each bullet's last step (velocity * dt back from where it is now). A bullet that hits
+// a wall stops there and bounces if it has bounces left, otherwise it dies.
+void collideBulletsWithObstacles(Obstacles& o, std::vector<Bullet>& bullets, float dt);
@@ -0,0 +1,154 @@
+#include "particles.h"
+
+#include "jobs.h"
+
+#include <SDL3/SDL_intrin.h>
+
+#include <algorithm>
+#include <cmath>
+
+static const int PARTICLE_GRAIN = 4096; // per job, below 2 chunks the update stays serial
+
+void initParticles(ParticleSystem& ps, int capacity) {
+    int cap = 4;
+    while (cap < capacity) cap *= 2;
+    ps.capacity = cap;
+    ps.x.assign(cap, 0.0f);
+    ps.y.assign(cap, 0.0f);
+    ps.vx.assign(cap, 0.0f);
+    ps.vy.assign(cap, 0.0f);
+    ps.life.assign(cap, 0.0f);
+    ps.invLife.assign(cap, 0.0f);
+    ps.size.assign(cap, 0.0f);
+    ps.fade.assign(cap, 0.0f);
+    ps.color.assign(cap, SDL_Color{ 0, 0, 0, 0 });
+    clearParticles(ps);
+}
+
+void clearParticles(ParticleSystem& ps) {
+    std::fill(ps.life.begin(), ps.life.end(), 0.0f);
+    std::fill(ps.fade.begin(), ps.fade.end(), 0.0f);
+    ps.head = 0;
+    ps.used = 0;
+    ps.alive = 0;
+}
+
+// xorshift32, [0, 1)
+static inline float nextRand(Uint32& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return (s >> 8) * (1.0f / 16777216.0f);
+}
+
+void emitParticles(ParticleSystem& ps, float x, float y, int count, float dirX, float dirY, float spread,
+                   float speedMin, float speedMax, float life, float size, SDL_Color color) {
+    if (ps.capacity == 0) return;
+    float base = std::atan2(dirY, dirX);
+    for (int k = 0; k < count; ++k) {
+        int i = ps.head;
+        ps.head = (ps.head + 1) & (ps.capacity - 1);
+        ps.used = std::max(ps.used, i + 1);
+
+        float a = base + (nextRand(ps.rng) - 0.5f) * spread;
+        float speed = speedMin + (speedMax - speedMin) * nextRand(ps.rng);
+        float l = life * (0.75f + 0.5f * nextRand(ps.rng));
+        ps.x[i] = x;
+        ps.y[i] = y;
+        ps.vx[i] = std::cos(a) * speed;
+        ps.vy[i] = std::sin(a) * speed;
+        ps.life[i] = l;
+        ps.invLife[i] = 1.0f / l;
+        ps.size[i] = size;
+        ps.fade[i] = 1.0f;
+        ps.color[i] = color;
+    }
+    ps.emitted += (Uint32)count;
+}
+
+// integrates [begin, end), both multiples of 4; returns the live count
+static int updateRange(ParticleSystem& ps, int begin, int end, float dt, float damp) {
+    float* x = ps.x.data();
+    float* y = ps.y.data();
+    float* vx = ps.vx.data();
+    float* vy = ps.vy.data();
+    float* life = ps.life.data();
+    const float* invLife = ps.invLife.data();
+    float* fade = ps.fade.data();
+    int alive = 0;
+    int i = begin;
+#ifdef SDL_SSE2_INTRINSICS
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vdamp = _mm_set1_ps(damp);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= end; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i);
+        __m128 pvx = _mm_loadu_ps(vx + i), pvy = _mm_loadu_ps(vy + i);
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(life + i), vdt);
+        _mm_storeu_ps(x + i, _mm_add_ps(px, _mm_mul_ps(pvx, vdt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(py, _mm_mul_ps(pvy, vdt)));
+        _mm_storeu_ps(vx + i, _mm_mul_ps(pvx, vdamp));
+        _mm_storeu_ps(vy + i, _mm_mul_ps(pvy, vdamp));
+        _mm_storeu_ps(life + i, l);
+        __m128 f = _mm_min_ps(one, _mm_mul_ps(_mm_max_ps(l, zero), _mm_loadu_ps(invLife + i)));
+        _mm_storeu_ps(fade + i, f);
+        int mask = _mm_movemask_ps(_mm_cmpgt_ps(l, zero));
+        alive += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+    }
+#endif
+    for (; i < end; ++i) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        vx[i] *= damp;
+        vy[i] *= damp;
+        life[i] -= dt;
+        fade[i] = std::min(1.0f, std::max(life[i], 0.0f) * invLife[i]);
+        alive += life[i] > 0.0f;
+    }
+    return alive;
+}
+
+struct ParticleJob {
+    ParticleSystem* ps;
+    float dt, damp;
+    SDL_AtomicInt alive;
+};
+
+static void particleJob(int begin, int end, void* user) {
+    ParticleJob& job = *(ParticleJob*)user;
+    int alive = updateRange(*job.ps, begin, end, job.dt, job.damp);
+    SDL_AddAtomicInt(&job.alive, alive);
+}
+
+void updateParticles(ParticleSystem& ps, float dt) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    // slots past `used` are dead, rounding up to whole SIMD groups stays inside capacity
+    int n = (ps.used + 3) & ~3;
+    ParticleJob job;
+    job.ps = &ps;
+    job.dt = dt;
+    job.damp = 1.0f / (1.0f + ps.drag * dt);
+    SDL_SetAtomicInt(&job.alive, 0);
+    parallelFor(n, PARTICLE_GRAIN, particleJob, &job);
+    ps.alive = SDL_GetAtomicInt(&job.alive);
+    // everything burned out, start the ring over so the next update touches few slots
+    if (ps.alive == 0) {
+        ps.head = 0;
+        ps.used = 0;
+    }
+    ps.updateMs = (float)((SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+
+void particlesToSnapshot(const ParticleSystem& ps, RenderSnapshot& s, const SDL_FRect& view) {
+    for (int i = 0; i < ps.used; ++i) {
+        float f = ps.fade[i];
+        if (f <= 0.0f) continue;
+        float sz = ps.size[i] * (0.4f + 0.6f * f);
+        SDL_FRect r{ ps.x[i] - sz * 0.5f, ps.y[i] - sz * 0.5f, sz, sz };
+        if (!aabb(r, view)) continue;
+        SDL_Color c = ps.color[i];
+        c.a = (Uint8)(c.a * f);
+        snapshotAddRect(s, r, c);
+    }
+}
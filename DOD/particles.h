@@ -0,0 +1,55 @@
+#pragma once
+
+#include "entities.h"
+#include "render_snapshot.h"
+
+#include <vector>
+
+// Hit sparks and death bursts. Structure of arrays so the update is a straight SIMD pass over
+// floats; slots come from a fixed-capacity ring, a burst into a full ring overwrites the oldest
+// particles instead of allocating. Large counts are updated in parallel on the job pool.
+// Everything is drawn as flat rects appended to the snapshot's single rect batch.
+struct ParticleSystem {
+    int capacity = 0; // power of two, >= 4
+    int head = 0;     // next slot to write
+    int used = 0;     // slots [0, used) may hold live particles
+    std::vector<float> x, y, vx, vy;
+    std::vector<float> life, invLife; // seconds left, 1 / starting life
+    std::vector<float> size;
+    std::vector<float> fade;          // life / starting life in [0, 1], written by the update
+    std::vector<SDL_Color> color;     // alpha is scaled by fade when drawn
+
+    float drag = 4.0f; // velocity damping, 1/s
+    Uint32 rng = 0x9E3779B9u; // own generator, emission must not disturb std::rand()
+
+    // last update
+    int alive = 0;
+    Uint32 emitted = 0;
+    float updateMs = 0.0f;
+};
+
+void initParticles(ParticleSystem& ps, int capacity);
+void clearParticles(ParticleSystem& ps);
+
+// count particles from (x, y) inside a cone of `spread` radians around (dirX, dirY)
+// (spread >= 2 pi: all around), speeds in [speedMin, speedMax], life jittered by +-25%
+void emitParticles(ParticleSystem& ps, float x, float y, int count, float dirX, float dirY, float spread,
+                   float speedMin, float speedMax, float life, float size, SDL_Color color);
+
+void updateParticles(ParticleSystem& ps, float dt);
+
+// live particles inside view, shrinking and fading out with their life
+void particlesToSnapshot(const ParticleSystem& ps, RenderSnapshot& s, const SDL_FRect& view);
+
+// effect presets used by the collision code
+static inline void emitHitSparks(ParticleSystem& ps, const SDL_FRect& bullet, Vec2 bulletVel, SDL_Color c) {
+    Vec2 d = normalize(bulletVel);
+    emitParticles(ps, bullet.x + bullet.w * 0.5f, bullet.y + bullet.h * 0.5f, 6, -d.x, -d.y, 1.6f,
+                  120.0f, 320.0f, 0.25f, 3.0f, c);
+}
+
+static inline void emitDeathBurst(ParticleSystem& ps, const SDL_FRect& mob, SDL_Color c) {
+    int count = 12 + (int)(mob.w * 0.5f);
+    emitParticles(ps, mob.x + mob.w * 0.5f, mob.y + mob.h * 0.5f, count, 1.0f, 0.0f, 7.0f,
+                  60.0f, 260.0f, 0.6f, 4.0f, c);
+}
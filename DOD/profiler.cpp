@@ -0,0 +1,82 @@
+#include "profiler.h"
+
+#include "imgui.h"
+
+#include <cfloat>
+
+static const int MAX_PROFILE_ZONES = 64;
+static const int MAX_PROFILE_COUNTERS = 64;
+static const int PROFILE_HISTORY = 120;
+
+struct ProfileZoneData {
+    const char* name;
+    Uint64 ticks;
+    float ms;
+    float avgMs;
+    float history[PROFILE_HISTORY];
+};
+
+struct ProfileCounterData {
+    const char* name;
+    double value;
+    double shown;
+};
+
+static ProfileZoneData g_zones[MAX_PROFILE_ZONES];
+static int g_zoneCount = 0;
+static ProfileCounterData g_counters[MAX_PROFILE_COUNTERS];
+static int g_counterCount = 0;
+static int g_historyPos = 0;
+
+int profileRegister(const char* name) {
+    for (int i = 0; i < g_zoneCount; ++i) {
+        if (SDL_strcmp(g_zones[i].name, name) == 0) return i;
+    }
+    if (g_zoneCount >= MAX_PROFILE_ZONES) return MAX_PROFILE_ZONES - 1;
+    ProfileZoneData& z = g_zones[g_zoneCount];
+    SDL_zero(z);
+    z.name = name;
+    return g_zoneCount++;
+}
+
+void profileAdd(int zone, Uint64 ticks) {
+    g_zones[zone].ticks += ticks;
+}
+
+void profileCounter(const char* name, double value) {
+    for (int i = 0; i < g_counterCount; ++i) {
+        if (SDL_strcmp(g_counters[i].name, name) == 0) { g_counters[i].value = value; return; }
+    }
+    if (g_counterCount >= MAX_PROFILE_COUNTERS) return;
+    g_counters[g_counterCount++] = { name, value, 0.0 };
+}
+
+void profileEndFrame() {
+    const double toMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    for (int i = 0; i < g_zoneCount; ++i) {
+        ProfileZoneData& z = g_zones[i];
+        z.ms = (float)(z.ticks * toMs);
+        z.avgMs = z.avgMs * 0.95f + z.ms * 0.05f;
+        z.history[g_historyPos] = z.ms;
+        z.ticks = 0;
+    }
+    for (int i = 0; i < g_counterCount; ++i) g_counters[i].shown = g_counters[i].value;
+    g_historyPos = (g_historyPos + 1) % PROFILE_HISTORY;
+}
+
+void drawProfilerWindow() {
+    ImGui::Begin("Profiler");
+    for (int i = 0; i < g_zoneCount; ++i) {
+        const ProfileZoneData& z = g_zones[i];
+        ImGui::PushID(i);
+        ImGui::PlotLines("##hist", z.history, PROFILE_HISTORY, g_historyPos, nullptr, 0.0f, FLT_MAX, ImVec2(80, 14));
+        ImGui::SameLine();
+        ImGui::Text("%-14s %6.3f ms (avg %6.3f)", z.name, z.ms, z.avgMs);
+        ImGui::PopID();
+    }
+    if (g_counterCount > 0) ImGui::Separator();
+    for (int i = 0; i < g_counterCount; ++i) {
+        ImGui::Text("%-22s %.6g", g_counters[i].name, g_counters[i].shown);
+    }
+    ImGui::End();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Minimal frame profiler: named CPU zones and counters, shown in the "Profiler" window.
+// Zones and counters are main thread only.
+
+int profileRegister(const char* name);
+void profileAdd(int zone, Uint64 ticks);
+void profileCounter(const char* name, double value);
+
+// latches this frame's values and resets the accumulators, call once per frame
+void profileEndFrame();
+void drawProfilerWindow();
+
+struct ProfileScope {
+    int zone;
+    Uint64 start;
+    explicit ProfileScope(int z) : zone(z), start(SDL_GetPerformanceCounter()) {}
+    ~ProfileScope() { profileAdd(zone, SDL_GetPerformanceCounter() - start); }
+};
+
+#define PROFILE_CAT2(a, b) a##b
+#define PROFILE_CAT(a, b) PROFILE_CAT2(a, b)
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_CAT(profZone_, __LINE__) = profileRegister(name); \
+    ProfileScope PROFILE_CAT(profScope_, __LINE__)(PROFILE_CAT(profZone_, __LINE__))
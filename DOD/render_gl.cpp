@@ -0,0 +1,277 @@
+#include "render_gl.h"
+
+#include "gl_ext.h"
+#include "gl_ring.h"
+
+#include "backends/imgui_impl_opengl3.h"
+
+#include <cstdio>
+
+static const SpriteUV WHITE_UV = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+static void drawRectGL(const SDL_FRect& r, const SDL_Color& c, const SpriteUV& uv) {
+    glColor4f(c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, c.a / 255.0f);
+    glBegin(GL_QUADS);
+    glTexCoord2f(uv.u0, uv.v0); glVertex2f(r.x, r.y);
+    glTexCoord2f(uv.u1, uv.v0); glVertex2f(r.x + r.w, r.y);
+    glTexCoord2f(uv.u1, uv.v1); glVertex2f(r.x + r.w, r.y + r.h);
+    glTexCoord2f(uv.u0, uv.v1); glVertex2f(r.x, r.y + r.h);
+    glEnd();
+}
+
+static const char* INSTANCED_VS =
+    "#version 130\n"
+    "in vec2 aCorner;\n"
+    "in vec4 aRect;\n"
+    "in vec4 aColor;\n"
+    "in float aSprite;\n"
+    "uniform vec2 uViewSize;\n"
+    "uniform vec4 uSpriteUV[128];\n"
+    "out vec4 vColor;\n"
+    "out vec2 vUV;\n"
+    "void main() {\n"
+    "    vec2 p = aRect.xy + aCorner * aRect.zw;\n"
+    "    gl_Position = vec4(p.x / uViewSize.x * 2.0 - 1.0, 1.0 - p.y / uViewSize.y * 2.0, 0.0, 1.0);\n"
+    "    vec4 uv = uSpriteUV[int(aSprite)];\n"
+    "    vUV = mix(uv.xy, uv.zw, aCorner);\n"
+    "    vColor = aColor;\n"
+    "}\n";
+
+static const char* INSTANCED_FS =
+    "#version 130\n"
+    "in vec4 vColor;\n"
+    "in vec2 vUV;\n"
+    "uniform sampler2D uAtlas;\n"
+    "out vec4 outColor;\n"
+    "void main() { outColor = vColor * texture(uAtlas, vUV); }\n";
+static_assert(MAX_SPRITES == 128, "uSpriteUV size in INSTANCED_VS");
+
+static const size_t RING_SEGMENT_SIZE = 16 * 1024 * 1024;
+
+static void* ringAllocForImGui(void* user, size_t size, size_t align, unsigned int* outBuffer, size_t* outOffset) {
+    GLRingBuffer& ring = *(GLRingBuffer*)user;
+    *outBuffer = ring.buffer;
+    return glRingAlloc(ring, size, align, outOffset);
+}
+
+static void initRing(GLRenderer& gl) {
+    gl.ring = new GLRingBuffer();
+    if (!loadGLExt() || !glRingCreate(*gl.ring, RING_SEGMENT_SIZE)) {
+        printf("Persistent-mapped buffers unavailable, using glBufferData\n");
+        delete gl.ring;
+        gl.ring = nullptr;
+        return;
+    }
+    ImGui_ImplOpenGL3_SetStreamAllocator(ringAllocForImGui, gl.ring);
+}
+
+static const SpriteUV& spriteUV(const GLRenderer& gl, Uint16 sprite) {
+    if (!gl.atlas || sprite >= gl.atlas->uvs.size()) return WHITE_UV;
+    return gl.atlas->uvs[sprite];
+}
+
+// Without an atlas the texture is a single white texel, so flat rects go through the same shader.
+static void glSetAtlas(void* self, const SpriteAtlas* atlas) {
+    GLRenderer& gl = *(GLRenderer*)self;
+    if (atlas == gl.atlas && gl.atlasTex) return;
+    Uint64 start = SDL_GetPerformanceCounter();
+    static const Uint32 white = 0xFFFFFFFFu;
+    gl.atlas = atlas;
+    if (!gl.atlasTex) glGenTextures(1, &gl.atlasTex);
+    glBindTexture(GL_TEXTURE_2D, gl.atlasTex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlas ? atlas->w : 1, atlas ? atlas->h : 1, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 atlas ? (const void*)atlas->pixels.data() : (const void*)&white);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (gl.program) {
+        // constant until the next atlas (sampler stays on unit 0)
+        SpriteUV uvs[MAX_SPRITES] = {};
+        for (int i = 0; i < MAX_SPRITES; ++i) uvs[i] = spriteUV(gl, (Uint16)i);
+        glx.UseProgram(gl.program);
+        glx.Uniform4fv(glx.GetUniformLocation(gl.program, "uSpriteUV"), MAX_SPRITES, &uvs[0].u0);
+        glx.UseProgram(0);
+    }
+    if (atlas) reportAtlasUpload(gl.instanced ? "gl-instanced" : "gl", start);
+}
+
+static bool initInstanced(GLRenderer& gl) {
+    if (!loadGLExt()) return false;
+    const char* attribs[] = { "aCorner", "aRect", "aColor", "aSprite" };
+    gl.program = buildGLProgram(INSTANCED_VS, INSTANCED_FS, attribs, 4);
+    if (!gl.program) return false;
+    gl.viewSizeLoc = glx.GetUniformLocation(gl.program, "uViewSize");
+
+    static const float corners[] = { 0, 0, 1, 0, 1, 1, 0, 1 };
+    glx.GenVertexArrays(1, &gl.vao);
+    glx.GenBuffers(1, &gl.cornerVbo);
+    glx.GenBuffers(1, &gl.rectVbo);
+    glx.GenBuffers(1, &gl.colorVbo);
+    glx.GenBuffers(1, &gl.spriteVbo);
+
+    glx.BindVertexArray(gl.vao);
+    glx.BindBuffer(GL_ARRAY_BUFFER, gl.cornerVbo);
+    glx.BufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glx.EnableVertexAttribArray(0);
+    glx.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // per-instance rect + color + sprite, pointers are set per frame (own buffers or the ring)
+    for (GLuint attr = 1; attr <= 3; ++attr) {
+        glx.EnableVertexAttribArray(attr);
+        glx.VertexAttribDivisor(attr, 1);
+    }
+
+    glx.BindVertexArray(0);
+    glx.BindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+static bool glInit(void* self) {
+    GLRenderer& gl = *(GLRenderer*)self;
+    SDL_GL_MakeCurrent(gl.window, gl.context);
+    SDL_GL_SetSwapInterval(1);
+    if (gl.instanced && !initInstanced(gl)) {
+        printf("Instanced GL path unavailable\n");
+        SDL_GL_MakeCurrent(gl.window, nullptr);
+        return false;
+    }
+    gl.atlas = nullptr;
+    glSetAtlas(&gl, nullptr);
+    ImGui_ImplOpenGL3_Init("#version 130");
+    ImGui_ImplOpenGL3_NewFrame(); // creates the device objects on this thread
+    if (gl.useRing) initRing(gl);
+    return true;
+}
+
+static void glBeginFrame(void* self, int viewW, int viewH) {
+    GLRenderer& gl = *(GLRenderer*)self;
+    gl.viewW = viewW;
+    gl.viewH = viewH;
+    if (gl.ring) glRingBeginFrame(*gl.ring);
+    glViewport(0, 0, viewW, viewH);
+    glClearColor(0.07f, 0.07f, 0.09f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (!gl.instanced) {
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(0.0, viewW, viewH, 0.0, -1.0, 1.0);
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+    }
+}
+
+static void glDrawRectsImmediate(void* self, const SDL_FRect* rects, const SDL_Color* colors, const Uint16* sprites,
+                                 size_t count) {
+    GLRenderer& gl = *(GLRenderer*)self;
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, gl.atlasTex);
+    for (size_t i = 0; i < count; ++i) drawRectGL(rects[i], colors[i], spriteUV(gl, sprites[i]));
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+}
+
+static void glDrawRectsInstanced(void* self, const SDL_FRect* rects, const SDL_Color* colors, const Uint16* sprites,
+                                 size_t count) {
+    GLRenderer& gl = *(GLRenderer*)self;
+    GLuint rectBuf = gl.rectVbo, colorBuf = gl.colorVbo, spriteBuf = gl.spriteVbo;
+    size_t rectOff = 0, colorOff = 0, spriteOff = 0;
+    void* rectDst = gl.ring ? glRingAlloc(*gl.ring, count * sizeof(SDL_FRect), 16, &rectOff) : nullptr;
+    void* colorDst = rectDst ? glRingAlloc(*gl.ring, count * sizeof(SDL_Color), 16, &colorOff) : nullptr;
+    void* spriteDst = colorDst ? glRingAlloc(*gl.ring, count * sizeof(Uint16), 16, &spriteOff) : nullptr;
+    if (spriteDst) {
+        SDL_memcpy(rectDst, rects, count * sizeof(SDL_FRect));
+        SDL_memcpy(colorDst, colors, count * sizeof(SDL_Color));
+        SDL_memcpy(spriteDst, sprites, count * sizeof(Uint16));
+        rectBuf = colorBuf = spriteBuf = gl.ring->buffer;
+    }
+    else {
+        // orphan + refill; capacity only grows
+        rectOff = colorOff = spriteOff = 0;
+        if (count > gl.capacity) gl.capacity = SDL_max(count, gl.capacity * 2);
+        glx.BindBuffer(GL_ARRAY_BUFFER, gl.rectVbo);
+        glx.BufferData(GL_ARRAY_BUFFER, gl.capacity * sizeof(SDL_FRect), nullptr, GL_STREAM_DRAW);
+        glx.BufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(SDL_FRect), rects);
+        glx.BindBuffer(GL_ARRAY_BUFFER, gl.colorVbo);
+        glx.BufferData(GL_ARRAY_BUFFER, gl.capacity * sizeof(SDL_Color), nullptr, GL_STREAM_DRAW);
+        glx.BufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(SDL_Color), colors);
+        glx.BindBuffer(GL_ARRAY_BUFFER, gl.spriteVbo);
+        glx.BufferData(GL_ARRAY_BUFFER, gl.capacity * sizeof(Uint16), nullptr, GL_STREAM_DRAW);
+        glx.BufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(Uint16), sprites);
+    }
+
+    glx.BindVertexArray(gl.vao);
+    glx.BindBuffer(GL_ARRAY_BUFFER, rectBuf);
+    glx.VertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SDL_FRect), (const void*)rectOff);
+    glx.BindBuffer(GL_ARRAY_BUFFER, colorBuf);
+    glx.VertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SDL_Color), (const void*)colorOff);
+    glx.BindBuffer(GL_ARRAY_BUFFER, spriteBuf);
+    glx.VertexAttribPointer(3, 1, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(Uint16), (const void*)spriteOff);
+    glx.BindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glx.UseProgram(gl.program);
+    glx.Uniform2f(gl.viewSizeLoc, (float)gl.viewW, (float)gl.viewH);
+    glBindTexture(GL_TEXTURE_2D, gl.atlasTex);
+    glx.DrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, (GLsizei)count);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glx.BindVertexArray(0);
+    glx.UseProgram(0);
+}
+
+static void glDrawImGui(void*, ImDrawData* drawData) {
+    ImGui_ImplOpenGL3_RenderDrawData(drawData);
+}
+
+static void glEndFrame(void* self) {
+    GLRenderer& gl = *(GLRenderer*)self;
+    if (gl.ring) glRingEndFrame(*gl.ring);
+    SDL_GL_SwapWindow(gl.window);
+}
+
+static void glShutdown(void* self) {
+    GLRenderer& gl = *(GLRenderer*)self;
+    if (gl.ring) {
+        printf("GL ring: peak %zu KB of %zu KB per frame, %d fallbacks, %.1f ms waiting on fences\n",
+               gl.ring->peakUsed / 1024, gl.ring->segmentSize / 1024, gl.ring->failedAllocs, gl.ring->waitMs);
+        ImGui_ImplOpenGL3_SetStreamAllocator(nullptr, nullptr);
+        glRingDestroy(*gl.ring);
+        delete gl.ring;
+        gl.ring = nullptr;
+    }
+    ImGui_ImplOpenGL3_Shutdown();
+    if (gl.atlasTex) {
+        glDeleteTextures(1, &gl.atlasTex);
+        gl.atlasTex = 0;
+        gl.atlas = nullptr;
+    }
+    if (gl.program) {
+        glx.DeleteBuffers(1, &gl.cornerVbo);
+        glx.DeleteBuffers(1, &gl.rectVbo);
+        glx.DeleteBuffers(1, &gl.colorVbo);
+        glx.DeleteBuffers(1, &gl.spriteVbo);
+        glx.DeleteVertexArrays(1, &gl.vao);
+        glx.DeleteProgram(gl.program);
+        gl.program = 0;
+    }
+    SDL_GL_MakeCurrent(gl.window, nullptr);
+}
+
+Renderer glRendererInterface(GLRenderer& gl) {
+    Renderer r;
+    r.name = gl.instanced ? "gl-instanced" : "gl";
+    r.init = glInit;
+    r.setAtlas = glSetAtlas;
+    r.beginFrame = glBeginFrame;
+    r.drawRects = gl.instanced ? glDrawRectsInstanced : glDrawRectsImmediate;
+    r.drawImGui = glDrawImGui;
+    r.endFrame = glEndFrame;
+    r.shutdown = glShutdown;
+    r.self = &gl;
+    return r;
+}
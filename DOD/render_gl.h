@@ -0,0 +1,36 @@
+#pragma once
+
+#include "renderer.h"
+
+struct GLRingBuffer;
+
+// OpenGL output for render snapshots. Immediate mode draws each rect with glBegin/glEnd;
+// instanced mode streams the snapshot's rect and color arrays as-is into two instance
+// buffers and draws them all with one glDrawArraysInstanced. ImGui goes through
+// imgui_impl_opengl3 in both modes. Sprites come from one atlas texture in both modes; the
+// instanced shader looks the UVs up in a uniform table indexed by the per-instance sprite id.
+// With useRing, instance data and ImGui vertices go through one persistent-mapped ring
+// buffer instead of per-frame glBufferData; without GL 4.4 / ARB_buffer_storage it stays off.
+struct GLRenderer {
+    SDL_Window* window = nullptr;
+    SDL_GLContext context = nullptr;
+    bool instanced = false;
+    bool useRing = false;
+    GLRingBuffer* ring = nullptr; // created on the render thread when useRing works
+    const SpriteAtlas* atlas = nullptr; // the one in atlasTex, nullptr = 1x1 white
+    unsigned int atlasTex = 0;
+
+    // instanced path
+    unsigned int program = 0;
+    int viewSizeLoc = -1;
+    unsigned int vao = 0;
+    unsigned int cornerVbo = 0;
+    unsigned int rectVbo = 0;   // SDL_FRect per instance
+    unsigned int colorVbo = 0;  // SDL_Color per instance
+    unsigned int spriteVbo = 0; // Uint16 sprite id per instance
+    size_t capacity = 0;        // instances the buffers can hold
+    int viewW = 0, viewH = 0;
+};
+
+// The init callback makes the context current on the calling thread.
+Renderer glRendererInterface(GLRenderer& gl);
@@ -0,0 +1,116 @@
+#include "render_sdl.h"
+
+#include "backends/imgui_impl_sdlrenderer3.h"
+
+#include <cstdio>
+
+static bool sdlInit(void* self) {
+    SDLRenderer& sdl = *(SDLRenderer*)self;
+    sdl.renderer = SDL_CreateRenderer(sdl.window, sdl.driver);
+    if (!sdl.renderer) {
+        printf("CreateRenderer failed: %s\n", SDL_GetError());
+        return false;
+    }
+    SDL_SetRenderVSync(sdl.renderer, 1);
+    SDL_SetRenderDrawBlendMode(sdl.renderer, SDL_BLENDMODE_BLEND);
+    printf("SDL renderer: %s\n", SDL_GetRendererName(sdl.renderer));
+    ImGui_ImplSDLRenderer3_Init(sdl.renderer);
+    return true;
+}
+
+static void sdlSetAtlas(void* self, const SpriteAtlas* atlas) {
+    SDLRenderer& sdl = *(SDLRenderer*)self;
+    if (atlas == sdl.atlas) return;
+    if (sdl.atlasTexture) SDL_DestroyTexture(sdl.atlasTexture);
+    sdl.atlasTexture = nullptr;
+    sdl.atlas = atlas;
+    if (!atlas) return;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    sdl.atlasTexture = SDL_CreateTexture(sdl.renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                         atlas->w, atlas->h);
+    if (sdl.atlasTexture) {
+        SDL_UpdateTexture(sdl.atlasTexture, nullptr, atlas->pixels.data(), atlas->w * 4);
+        SDL_SetTextureBlendMode(sdl.atlasTexture, SDL_BLENDMODE_BLEND);
+        reportAtlasUpload("sdl", start);
+    }
+    else printf("Atlas texture create failed: %s\n", SDL_GetError());
+}
+
+static void sdlBeginFrame(void* self, int, int) {
+    SDLRenderer& sdl = *(SDLRenderer*)self;
+    sdl.frameStart = SDL_GetPerformanceCounter();
+    SDL_SetRenderDrawColor(sdl.renderer, 18, 18, 23, 255);
+    SDL_RenderClear(sdl.renderer);
+}
+
+// toate entitatile intr-un singur draw call
+static void sdlDrawRects(void* self, const SDL_FRect* rects, const SDL_Color* colors, const Uint16* sprites,
+                         size_t count) {
+    SDLRenderer& sdl = *(SDLRenderer*)self;
+    const SpriteAtlas* atlas = sdl.atlasTexture ? sdl.atlas : nullptr;
+    sdl.vertices.resize(count * 4);
+    for (size_t i = 0; i < count; ++i) {
+        const SDL_FRect& r = rects[i];
+        const SDL_Color& c = colors[i];
+        SpriteUV uv = { 0.0f, 0.0f, 0.0f, 0.0f };
+        if (atlas && sprites[i] < atlas->uvs.size()) uv = atlas->uvs[sprites[i]];
+        SDL_FColor fc{ c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, c.a / 255.0f };
+        SDL_Vertex* v = &sdl.vertices[i * 4];
+        v[0] = { { r.x,       r.y       }, fc, { uv.u0, uv.v0 } };
+        v[1] = { { r.x + r.w, r.y       }, fc, { uv.u1, uv.v0 } };
+        v[2] = { { r.x + r.w, r.y + r.h }, fc, { uv.u1, uv.v1 } };
+        v[3] = { { r.x,       r.y + r.h }, fc, { uv.u0, uv.v1 } };
+    }
+
+    size_t quads = sdl.indices.size() / 6;
+    if (quads < count) {
+        sdl.indices.resize(count * 6);
+        for (size_t q = quads; q < count; ++q) {
+            int base = (int)q * 4;
+            int* idx = &sdl.indices[q * 6];
+            idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+            idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+        }
+    }
+
+    SDL_RenderGeometry(sdl.renderer, sdl.atlasTexture, sdl.vertices.data(), (int)sdl.vertices.size(),
+                       sdl.indices.data(), (int)count * 6);
+}
+
+static void sdlDrawImGui(void* self, ImDrawData* drawData) {
+    SDLRenderer& sdl = *(SDLRenderer*)self;
+    ImGui_ImplSDLRenderer3_RenderDrawData(drawData, sdl.renderer);
+}
+
+static void sdlEndFrame(void* self) {
+    SDLRenderer& sdl = *(SDLRenderer*)self;
+    sdl.submitMs = (float)((SDL_GetPerformanceCounter() - sdl.frameStart) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+    SDL_RenderPresent(sdl.renderer);
+}
+
+static void sdlShutdown(void* self) {
+    SDLRenderer& sdl = *(SDLRenderer*)self;
+    if (!sdl.renderer) return;
+    ImGui_ImplSDLRenderer3_Shutdown();
+    if (sdl.atlasTexture) SDL_DestroyTexture(sdl.atlasTexture);
+    sdl.atlasTexture = nullptr;
+    sdl.atlas = nullptr;
+    SDL_DestroyRenderer(sdl.renderer);
+    sdl.renderer = nullptr;
+}
+
+Renderer sdlRendererInterface(SDLRenderer& sdl) {
+    Renderer r;
+    r.name = "sdl";
+    r.init = sdlInit;
+    r.setAtlas = sdlSetAtlas;
+    r.beginFrame = sdlBeginFrame;
+    r.drawRects = sdlDrawRects;
+    r.drawImGui = sdlDrawImGui;
+    r.endFrame = sdlEndFrame;
+    r.shutdown = sdlShutdown;
+    r.self = &sdl;
+    r.mainThreadOnly = true;
+    return r;
+}
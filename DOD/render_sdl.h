@@ -0,0 +1,29 @@
+#pragma once
+
+#include "renderer.h"
+
+#include <vector>
+
+// SDL_Renderer output for render snapshots: every rect of the frame goes out as one
+// SDL_RenderGeometry call (textured from the sprite atlas when there is one), ImGui through
+// imgui_impl_sdlrenderer3. Works with any SDL render
+// driver, including "software". SDL_Renderer is not thread safe, so this one always runs
+// on the main thread.
+struct SDLRenderer {
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    const char* driver = nullptr; // nullptr = let SDL pick
+    const SpriteAtlas* atlas = nullptr; // the one in atlasTexture
+    SDL_Texture* atlasTexture = nullptr;
+
+    // persistent geometry, grows to the largest frame seen
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices; // fixed quad pattern, only extended when more rects show up
+
+    // last frame, begin to just before present
+    Uint64 frameStart = 0;
+    float submitMs = 0.0f;
+};
+
+// init creates the SDL_Renderer for sdl.window and initializes the ImGui backend.
+Renderer sdlRendererInterface(SDLRenderer& sdl);
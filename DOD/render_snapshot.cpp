@@ -0,0 +1,98 @@
+#include "render_snapshot.h"
+
+void snapshotBegin(RenderSnapshot& s, int viewW, int viewH, Uint64 frame) {
+    s.viewW = viewW;
+    s.viewH = viewH;
+    s.frame = frame;
+    s.originX = 0.0f;
+    s.originY = 0.0f;
+    s.rects.clear();
+    s.colors.clear();
+    s.sprites.clear();
+    s.imgui.Clear();
+    s.liveTextures = false;
+}
+
+void snapshotAddRects(RenderSnapshot& s, const SDL_FRect* rects, const SDL_Color* colors,
+                      const Uint16* sprites, size_t count) {
+    size_t base = s.rects.size();
+    s.rects.insert(s.rects.end(), rects, rects + count);
+    for (size_t i = base; i < s.rects.size(); ++i) {
+        s.rects[i].x -= s.originX;
+        s.rects[i].y -= s.originY;
+    }
+    s.colors.insert(s.colors.end(), colors, colors + count);
+    if (sprites) s.sprites.insert(s.sprites.end(), sprites, sprites + count);
+    else s.sprites.resize(s.sprites.size() + count, SPRITE_NONE);
+}
+
+void snapshotAddRectsIndexed(RenderSnapshot& s, const SDL_FRect* rects, const SDL_Color* colors,
+                             const Uint16* sprites, const std::vector<Uint32>& indices) {
+    size_t base = s.rects.size();
+    s.rects.resize(base + indices.size());
+    s.colors.resize(base + indices.size());
+    s.sprites.resize(base + indices.size(), SPRITE_NONE);
+    for (size_t k = 0; k < indices.size(); ++k) {
+        const SDL_FRect& r = rects[indices[k]];
+        s.rects[base + k] = { r.x - s.originX, r.y - s.originY, r.w, r.h };
+        s.colors[base + k] = colors[indices[k]];
+        if (sprites) s.sprites[base + k] = sprites[indices[k]];
+    }
+}
+
+// ImVector::operator= frees and reallocates, this keeps the capacity
+template <typename T>
+static void copyInto(ImVector<T>& dst, const ImVector<T>& src) {
+    dst.resize(src.Size);
+    if (src.Size > 0) SDL_memcpy(dst.Data, src.Data, (size_t)src.Size * sizeof(T));
+}
+
+bool imguiTexturesPending(const ImDrawData* src) {
+    if (!src->Textures) return false;
+    for (ImTextureData* tex : *src->Textures) {
+        if (tex->Status != ImTextureStatus_OK) return true;
+    }
+    return false;
+}
+
+void snapshotCopyImGui(RenderSnapshot& s, const ImDrawData* src, bool keepLiveTextures) {
+    while (s.imguiLists.Size < src->CmdLists.Size) {
+        s.imguiLists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+    }
+
+    ImDrawData& dst = s.imgui;
+    dst.Clear();
+    dst.Valid = src->Valid;
+    dst.DisplayPos = src->DisplayPos;
+    dst.DisplaySize = src->DisplaySize;
+    dst.FramebufferScale = src->FramebufferScale;
+    dst.Textures = keepLiveTextures ? src->Textures : nullptr;
+
+    for (int i = 0; i < src->CmdLists.Size; ++i) {
+        const ImDrawList* from = src->CmdLists[i];
+        ImDrawList* to = s.imguiLists[i];
+        copyInto(to->CmdBuffer, from->CmdBuffer);
+        copyInto(to->IdxBuffer, from->IdxBuffer);
+        copyInto(to->VtxBuffer, from->VtxBuffer);
+        to->Flags = from->Flags;
+        if (!keepLiveTextures) {
+            for (ImDrawCmd& cmd : to->CmdBuffer) {
+                if (cmd.UserCallback == nullptr) cmd.TexRef = ImTextureRef(cmd.GetTexID());
+            }
+        }
+        dst.CmdLists.push_back(to);
+        dst.TotalVtxCount += to->VtxBuffer.Size;
+        dst.TotalIdxCount += to->IdxBuffer.Size;
+    }
+    dst.CmdListsCount = dst.CmdLists.Size;
+    s.liveTextures = keepLiveTextures;
+}
+
+void snapshotFree(RenderSnapshot& s) {
+    for (ImDrawList* list : s.imguiLists) IM_DELETE(list);
+    s.imguiLists.clear();
+    s.imgui.Clear();
+    s.rects.clear();
+    s.colors.clear();
+    s.sprites.clear();
+}
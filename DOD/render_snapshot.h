@@ -0,0 +1,58 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include "imgui.h"
+#include "sprite_atlas.h"
+
+#include <vector>
+
+// Everything the render side needs for one frame: packed rects/colors/sprites in draw order plus
+// a private copy of the ImGui draw lists. Filled by the simulation, read-only once published.
+struct RenderSnapshot {
+    int viewW = 0;
+    int viewH = 0;
+    float originX = 0.0f, originY = 0.0f; // camera, world rects are stored relative to it
+    Uint64 frame = 0;
+    std::vector<SDL_FRect> rects;
+    std::vector<SDL_Color> colors;
+    std::vector<Uint16> sprites; // atlas sprite per rect, SPRITE_NONE = flat color
+    const SpriteAtlas* atlas = nullptr; // immutable once set, nullptr while still loading
+
+    ImDrawData imgui;
+    ImVector<ImDrawList*> imguiLists; // owned, reused between frames
+    // imgui still points at live ImGui textures that need uploading; the producer must not
+    // start the next ImGui frame until this snapshot has been rendered
+    bool liveTextures = false;
+};
+
+void snapshotBegin(RenderSnapshot& s, int viewW, int viewH, Uint64 frame);
+
+// world position shown at the top-left corner; the add functions below take world rects
+static inline void snapshotSetOrigin(RenderSnapshot& s, float x, float y) {
+    s.originX = x;
+    s.originY = y;
+}
+
+static inline void snapshotAddRect(RenderSnapshot& s, const SDL_FRect& r, const SDL_Color& c,
+                                   Uint16 sprite = SPRITE_NONE) {
+    s.rects.push_back({ r.x - s.originX, r.y - s.originY, r.w, r.h });
+    s.colors.push_back(c);
+    s.sprites.push_back(sprite);
+}
+
+// sprites may be nullptr (all flat)
+void snapshotAddRects(RenderSnapshot& s, const SDL_FRect* rects, const SDL_Color* colors,
+                      const Uint16* sprites, size_t count);
+// only rects[indices[k]], e.g. a visible list from cull.h
+void snapshotAddRectsIndexed(RenderSnapshot& s, const SDL_FRect* rects, const SDL_Color* colors,
+                             const Uint16* sprites, const std::vector<Uint32>& indices);
+
+// true if any ImGui texture has a pending create/update/destroy request
+bool imguiTexturesPending(const ImDrawData* src);
+
+// Copies the draw lists. With keepLiveTextures the texture requests are forwarded to the
+// renderer, otherwise texture references are resolved to plain ids.
+void snapshotCopyImGui(RenderSnapshot& s, const ImDrawData* src, bool keepLiveTextures);
+
+void snapshotFree(RenderSnapshot& s);
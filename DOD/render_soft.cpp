@@ -0,0 +1,565 @@
+#include "render_soft.h"
+
+#include "jobs.h"
+
+#include <SDL3/SDL_intrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// ---------------------------------------------------------------------------------------------
+// textures
+
+static int allocTexture(SoftRenderer& r) {
+    if (!r.freeTextures.empty()) {
+        int id = r.freeTextures.back();
+        r.freeTextures.pop_back();
+        return id;
+    }
+    r.textures.push_back(SoftTexture());
+    return (int)r.textures.size() - 1;
+}
+
+static void copyTexturePixels(SoftTexture& dst, ImTextureData* tex) {
+    dst.w = tex->Width;
+    dst.h = tex->Height;
+    dst.pixels.resize((size_t)dst.w * dst.h);
+    const unsigned char* src = (const unsigned char*)tex->GetPixels();
+    if (tex->Format == ImTextureFormat_RGBA32) {
+        SDL_memcpy(dst.pixels.data(), src, dst.pixels.size() * 4);
+    }
+    else {
+        for (size_t i = 0; i < dst.pixels.size(); ++i) dst.pixels[i] = 0x00FFFFFFu | ((Uint32)src[i] << 24);
+    }
+}
+
+static void updateTexture(SoftRenderer& r, ImTextureData* tex) {
+    if (tex->Status == ImTextureStatus_WantCreate) {
+        int id = allocTexture(r);
+        copyTexturePixels(r.textures[id], tex);
+        tex->SetTexID((ImTextureID)(id + 1));
+        tex->SetStatus(ImTextureStatus_OK);
+    }
+    else if (tex->Status == ImTextureStatus_WantUpdates) {
+        // the CPU copy is cheap enough to refresh whole
+        copyTexturePixels(r.textures[(int)tex->TexID - 1], tex);
+        tex->SetStatus(ImTextureStatus_OK);
+    }
+    else if (tex->Status == ImTextureStatus_WantDestroy && tex->UnusedFrames > 0) {
+        int id = (int)tex->TexID - 1;
+        r.textures[id].pixels.clear();
+        r.freeTextures.push_back(id);
+        tex->SetTexID(ImTextureID_Invalid);
+        tex->SetStatus(ImTextureStatus_Destroyed);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// pixel ops
+
+static inline Uint32 packColor(const SDL_Color& c) {
+    return (Uint32)c.r | ((Uint32)c.g << 8) | ((Uint32)c.b << 16) | ((Uint32)c.a << 24);
+}
+
+// out = (s * a + d * (255 - a)) / 255 per channel, source alpha channel counts as 255.
+// The SIMD and scalar paths give identical results so golden images do not depend on the CPU.
+static inline Uint32 blendPixel(Uint32 src, Uint32 dst, Uint32 a) {
+    Uint32 out = 0;
+    for (int sh = 0; sh < 32; sh += 8) {
+        Uint32 s = sh == 24 ? 255u : (src >> sh) & 0xFF;
+        Uint32 d = (dst >> sh) & 0xFF;
+        Uint32 t = s * a + d * (255 - a) + 128;
+        out |= (((t + (t >> 8)) >> 8) & 0xFF) << sh;
+    }
+    return out;
+}
+
+static void fillSpan(Uint32* p, int n, Uint32 color) {
+    int i = 0;
+#ifdef SDL_SSE2_INTRINSICS
+    __m128i c = _mm_set1_epi32((int)color);
+    for (; i + 4 <= n; i += 4) _mm_storeu_si128((__m128i*)(p + i), c);
+#endif
+    for (; i < n; ++i) p[i] = color;
+}
+
+static void blendSpan(Uint32* p, int n, Uint32 color, Uint32 a) {
+    int i = 0;
+#ifdef SDL_SSE2_INTRINSICS
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32((int)(color | 0xFF000000u)), zero);
+    const __m128i srcA = _mm_mullo_epi16(src, _mm_set1_epi16((short)a));
+    const __m128i invA = _mm_set1_epi16((short)(255 - a));
+    const __m128i half = _mm_set1_epi16(128);
+    for (; i + 4 <= n; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(srcA, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), invA)), half);
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(srcA, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), invA)), half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(p + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < n; ++i) p[i] = blendPixel(color, p[i], a);
+}
+
+// ---------------------------------------------------------------------------------------------
+// rasterization
+
+struct TileRect { int x0, y0, x1, y1; };
+
+static inline Uint32 mul255(Uint32 a, Uint32 b) {
+    Uint32 t = a * b + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+// texel * color, then blended like any other pixel
+static void rasterSprite(SoftRenderer& r, const SDL_FRect& rc, const SDL_Color& c,
+                         const SDL_Rect& src, int x0, int y0, int x1, int y1) {
+    const Uint32* pixels = r.atlas->pixels.data();
+    float sx = src.w / rc.w, sy = src.h / rc.h;
+    for (int y = y0; y < y1; ++y) {
+        int ty = std::min(src.h - 1, (int)((y + 0.5f - rc.y) * sy));
+        const Uint32* texRow = pixels + (size_t)(src.y + ty) * r.atlas->w + src.x;
+        Uint32* row = &r.framebuffer[(size_t)y * r.w];
+        for (int x = x0; x < x1; ++x) {
+            Uint32 tex = texRow[std::min(src.w - 1, (int)((x + 0.5f - rc.x) * sx))];
+            Uint32 a = mul255(tex >> 24, c.a);
+            if (a == 0) continue;
+            Uint32 col = mul255(tex & 0xFF, c.r) | (mul255((tex >> 8) & 0xFF, c.g) << 8) |
+                         (mul255((tex >> 16) & 0xFF, c.b) << 16) | 0xFF000000u;
+            row[x] = a == 255 ? col : blendPixel(col, row[x], a);
+        }
+    }
+}
+
+static void rasterRect(SoftRenderer& r, const TileRect& t, const SDL_FRect& rc, const SDL_Color& c, Uint16 sprite) {
+    // pixel centers inside [x, x + w), same coverage rule as GL
+    int x0 = std::max(t.x0, (int)std::ceil(rc.x - 0.5f));
+    int y0 = std::max(t.y0, (int)std::ceil(rc.y - 0.5f));
+    int x1 = std::min(t.x1, (int)std::ceil(rc.x + rc.w - 0.5f));
+    int y1 = std::min(t.y1, (int)std::ceil(rc.y + rc.h - 0.5f));
+    if (x0 >= x1 || y0 >= y1 || c.a == 0) return;
+    if (sprite != SPRITE_NONE && r.atlas && sprite < r.atlas->rects.size()) {
+        rasterSprite(r, rc, c, r.atlas->rects[sprite], x0, y0, x1, y1);
+        return;
+    }
+
+    Uint32 color = packColor(c);
+    for (int y = y0; y < y1; ++y) {
+        Uint32* row = &r.framebuffer[(size_t)y * r.w + x0];
+        if (c.a == 255) fillSpan(row, x1 - x0, color);
+        else blendSpan(row, x1 - x0, color, c.a);
+    }
+}
+
+static inline bool topLeft(float ax, float ay, float bx, float by) {
+    return (ay == by && bx > ax) || (by < ay);
+}
+
+static inline float lerpChannel(const Uint32 col[3], int sh, float b0, float b1, float b2) {
+    return ((col[0] >> sh) & 0xFF) * b0 + ((col[1] >> sh) & 0xFF) * b1 + ((col[2] >> sh) & 0xFF) * b2;
+}
+
+static void rasterTri(SoftRenderer& r, const TileRect& t, const SoftTri& tri) {
+    float x0 = tri.x[0], y0 = tri.y[0];
+    float x1 = tri.x[1], y1 = tri.y[1];
+    float x2 = tri.x[2], y2 = tri.y[2];
+    int i1 = 1, i2 = 2;
+    float area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+    if (area < 0.0f) {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+        std::swap(i1, i2);
+        area = -area;
+    }
+    if (area < 1e-6f) return;
+
+    int minX = std::max(std::max(t.x0, tri.clip[0]), (int)std::floor(std::min(x0, std::min(x1, x2))));
+    int minY = std::max(std::max(t.y0, tri.clip[1]), (int)std::floor(std::min(y0, std::min(y1, y2))));
+    int maxX = std::min(std::min(t.x1, tri.clip[2]), (int)std::ceil(std::max(x0, std::max(x1, x2))));
+    int maxY = std::min(std::min(t.y1, tri.clip[3]), (int)std::ceil(std::max(y0, std::max(y1, y2))));
+    if (minX >= maxX || minY >= maxY) return;
+
+    const bool tl0 = topLeft(x1, y1, x2, y2);
+    const bool tl1 = topLeft(x2, y2, x0, y0);
+    const bool tl2 = topLeft(x0, y0, x1, y1);
+    const float invArea = 1.0f / area;
+    const Uint32 col[3] = { tri.col[0], tri.col[i1], tri.col[i2] };
+    const float us[3] = { tri.u[0], tri.u[i1], tri.u[i2] };
+    const float vs[3] = { tri.v[0], tri.v[i1], tri.v[i2] };
+    const SoftTexture* tex = tri.tex >= 0 && tri.tex < (int)r.textures.size() ? &r.textures[tri.tex] : nullptr;
+    if (tex && tex->pixels.empty()) tex = nullptr;
+
+    for (int py = minY; py < maxY; ++py) {
+        float cy = py + 0.5f;
+        for (int px = minX; px < maxX; ++px) {
+            float cx = px + 0.5f;
+            float w0 = (x2 - x1) * (cy - y1) - (y2 - y1) * (cx - x1);
+            float w1 = (x0 - x2) * (cy - y2) - (y0 - y2) * (cx - x2);
+            float w2 = (x1 - x0) * (cy - y0) - (y1 - y0) * (cx - x0);
+            if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+            if ((w0 == 0.0f && !tl0) || (w1 == 0.0f && !tl1) || (w2 == 0.0f && !tl2)) continue;
+
+            float b0 = w0 * invArea, b1 = w1 * invArea, b2 = w2 * invArea;
+            float cr = lerpChannel(col, 0, b0, b1, b2);
+            float cg = lerpChannel(col, 8, b0, b1, b2);
+            float cb = lerpChannel(col, 16, b0, b1, b2);
+            float ca = lerpChannel(col, 24, b0, b1, b2);
+            if (tex) {
+                float u = us[0] * b0 + us[1] * b1 + us[2] * b2;
+                float v = vs[0] * b0 + vs[1] * b1 + vs[2] * b2;
+                int tx = std::min(tex->w - 1, std::max(0, (int)(u * tex->w)));
+                int ty = std::min(tex->h - 1, std::max(0, (int)(v * tex->h)));
+                Uint32 texel = tex->pixels[(size_t)ty * tex->w + tx];
+                cr *= (texel & 0xFF) / 255.0f;
+                cg *= ((texel >> 8) & 0xFF) / 255.0f;
+                cb *= ((texel >> 16) & 0xFF) / 255.0f;
+                ca *= (texel >> 24) / 255.0f;
+            }
+            Uint32 a = (Uint32)(ca + 0.5f);
+            if (a == 0) continue;
+            Uint32 src = (Uint32)(cr + 0.5f) | ((Uint32)(cg + 0.5f) << 8) | ((Uint32)(cb + 0.5f) << 16);
+            Uint32& dst = r.framebuffer[(size_t)py * r.w + px];
+            dst = a >= 255 ? (src | 0xFF000000u) : blendPixel(src, dst, a);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// frame
+
+static void gatherImGuiTris(SoftRenderer& r, const ImDrawData& dd) {
+    const ImVec2 off = dd.DisplayPos;
+    const ImVec2 scale = dd.FramebufferScale;
+    for (const ImDrawList* list : dd.CmdLists) {
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            if (cmd.UserCallback) continue; // no custom callbacks in this app
+            SoftTri tri;
+            tri.clip[0] = std::max(0, (int)((cmd.ClipRect.x - off.x) * scale.x));
+            tri.clip[1] = std::max(0, (int)((cmd.ClipRect.y - off.y) * scale.y));
+            tri.clip[2] = std::min(r.w, (int)std::ceil((cmd.ClipRect.z - off.x) * scale.x));
+            tri.clip[3] = std::min(r.h, (int)std::ceil((cmd.ClipRect.w - off.y) * scale.y));
+            if (tri.clip[0] >= tri.clip[2] || tri.clip[1] >= tri.clip[3]) continue;
+            tri.tex = (int)cmd.GetTexID() - 1;
+
+            const ImDrawIdx* idx = list->IdxBuffer.Data + cmd.IdxOffset;
+            const ImDrawVert* vtx = list->VtxBuffer.Data + cmd.VtxOffset;
+            for (unsigned int i = 0; i + 2 < cmd.ElemCount; i += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    const ImDrawVert& v = vtx[idx[i + k]];
+                    tri.x[k] = (v.pos.x - off.x) * scale.x;
+                    tri.y[k] = (v.pos.y - off.y) * scale.y;
+                    tri.u[k] = v.uv.x;
+                    tri.v[k] = v.uv.y;
+                    tri.col[k] = v.col;
+                }
+                r.tris.push_back(tri);
+            }
+        }
+    }
+}
+
+static inline void binRange(SoftRenderer& r, float fx0, float fy0, float fx1, float fy1, Uint32 prim) {
+    int tx0 = std::max(0, (int)std::floor(fx0) / SOFT_TILE);
+    int ty0 = std::max(0, (int)std::floor(fy0) / SOFT_TILE);
+    int tx1 = std::min(r.tilesX - 1, (int)std::ceil(fx1) / SOFT_TILE);
+    int ty1 = std::min(r.tilesY - 1, (int)std::ceil(fy1) / SOFT_TILE);
+    if (fx1 <= 0.0f || fy1 <= 0.0f) return;
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) r.tileBins[(size_t)ty * r.tilesX + tx].push_back(prim);
+    }
+}
+
+static void binPrims(SoftRenderer& r) {
+    for (auto& bin : r.tileBins) bin.clear();
+    r.binnedPrims = 0;
+    for (size_t i = 0; i < r.rects.size(); ++i) {
+        const SDL_FRect& rc = r.rects[i];
+        binRange(r, rc.x, rc.y, rc.x + rc.w, rc.y + rc.h, (Uint32)i);
+    }
+    for (size_t i = 0; i < r.tris.size(); ++i) {
+        const SoftTri& t = r.tris[i];
+        float x0 = std::max((float)t.clip[0], std::min(t.x[0], std::min(t.x[1], t.x[2])));
+        float y0 = std::max((float)t.clip[1], std::min(t.y[0], std::min(t.y[1], t.y[2])));
+        float x1 = std::min((float)t.clip[2], std::max(t.x[0], std::max(t.x[1], t.x[2])));
+        float y1 = std::min((float)t.clip[3], std::max(t.y[0], std::max(t.y[1], t.y[2])));
+        if (x0 < x1 && y0 < y1) binRange(r, x0, y0, x1, y1, (Uint32)i | SOFT_PRIM_TRI);
+    }
+    for (auto& bin : r.tileBins) r.binnedPrims += (int)bin.size();
+}
+
+static void rasterTile(SoftRenderer& r, int tile) {
+    int tx = tile % r.tilesX, ty = tile / r.tilesX;
+    TileRect t{ tx * SOFT_TILE, ty * SOFT_TILE,
+                std::min(r.w, (tx + 1) * SOFT_TILE), std::min(r.h, (ty + 1) * SOFT_TILE) };
+    for (int y = t.y0; y < t.y1; ++y) fillSpan(&r.framebuffer[(size_t)y * r.w + t.x0], t.x1 - t.x0, r.clearColor);
+
+    for (Uint32 prim : r.tileBins[tile]) {
+        if (prim & SOFT_PRIM_TRI) rasterTri(r, t, r.tris[prim & ~SOFT_PRIM_TRI]);
+        else rasterRect(r, t, r.rects[prim], r.colors[prim], r.sprites[prim]);
+    }
+}
+
+static bool softInit(void* self) {
+    SoftRenderer& r = *(SoftRenderer*)self;
+    r.clearColor = packColor({ 18, 18, 23, 255 }); // same as the GL clear (0.07, 0.07, 0.09)
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.BackendRendererName = "soft";
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset | ImGuiBackendFlags_RendererHasTextures;
+    return true;
+}
+
+static void softSetAtlas(void* self, const SpriteAtlas* atlas) {
+    ((SoftRenderer*)self)->atlas = atlas;
+}
+
+static void softBeginFrame(void* self, int viewW, int viewH) {
+    SoftRenderer& r = *(SoftRenderer*)self;
+    r.frameStart = SDL_GetPerformanceCounter();
+    if (r.w != viewW || r.h != viewH) {
+        r.w = viewW;
+        r.h = viewH;
+        r.framebuffer.assign((size_t)r.w * r.h, r.clearColor);
+        r.tilesX = (r.w + SOFT_TILE - 1) / SOFT_TILE;
+        r.tilesY = (r.h + SOFT_TILE - 1) / SOFT_TILE;
+        r.tileBins.resize((size_t)r.tilesX * r.tilesY);
+    }
+    r.rects.clear();
+    r.colors.clear();
+    r.sprites.clear();
+    r.tris.clear();
+}
+
+static void softDrawRects(void* self, const SDL_FRect* rects, const SDL_Color* colors, const Uint16* sprites,
+                          size_t count) {
+    SoftRenderer& r = *(SoftRenderer*)self;
+    r.rects.insert(r.rects.end(), rects, rects + count);
+    r.colors.insert(r.colors.end(), colors, colors + count);
+    r.sprites.insert(r.sprites.end(), sprites, sprites + count);
+}
+
+static void softDrawImGui(void* self, ImDrawData* drawData) {
+    SoftRenderer& r = *(SoftRenderer*)self;
+    if (drawData->Textures) {
+        for (ImTextureData* tex : *drawData->Textures) {
+            if (tex->Status != ImTextureStatus_OK) updateTexture(r, tex);
+        }
+    }
+    gatherImGuiTris(r, *drawData);
+}
+
+static void presentToWindow(SoftRenderer& r) {
+    SDL_Surface* dst = SDL_GetWindowSurface(r.window);
+    SDL_Surface* src = SDL_CreateSurfaceFrom(r.w, r.h, SDL_PIXELFORMAT_RGBA32, r.framebuffer.data(), r.w * 4);
+    if (dst && src) {
+        SDL_BlitSurface(src, nullptr, dst, nullptr);
+        SDL_UpdateWindowSurface(r.window);
+    }
+    SDL_DestroySurface(src);
+}
+
+static void softEndFrame(void* self) {
+    SoftRenderer& r = *(SoftRenderer*)self;
+    binPrims(r);
+    parallelFor(r.tilesX * r.tilesY, 1, [&r](int begin, int end) {
+        for (int tile = begin; tile < end; ++tile) rasterTile(r, tile);
+    });
+    r.rasterMs = (float)((SDL_GetPerformanceCounter() - r.frameStart) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+    if (r.window) presentToWindow(r);
+}
+
+static void softShutdown(void* self) {
+    SoftRenderer& r = *(SoftRenderer*)self;
+    for (ImTextureData* tex : ImGui::GetPlatformIO().Textures) {
+        if (tex->RefCount == 1 && tex->TexID != ImTextureID_Invalid) {
+            tex->SetTexID(ImTextureID_Invalid);
+            tex->SetStatus(ImTextureStatus_Destroyed);
+        }
+    }
+    r.textures.clear();
+    r.freeTextures.clear();
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.BackendRendererName = nullptr;
+    io.BackendFlags &= ~(ImGuiBackendFlags_RendererHasVtxOffset | ImGuiBackendFlags_RendererHasTextures);
+}
+
+Renderer softRendererInterface(SoftRenderer& r) {
+    Renderer out;
+    out.name = "soft";
+    out.init = softInit;
+    out.setAtlas = softSetAtlas;
+    out.beginFrame = softBeginFrame;
+    out.drawRects = softDrawRects;
+    out.drawImGui = softDrawImGui;
+    out.endFrame = softEndFrame;
+    out.shutdown = softShutdown;
+    out.self = &r;
+    out.mainThreadOnly = r.window != nullptr; // window surface belongs to the main thread
+    return out;
+}
+
+// ---------------------------------------------------------------------------------------------
+// image output / golden comparison
+
+static bool writeFile(const char* path, const void* data, size_t size) {
+    SDL_IOStream* io = SDL_IOFromFile(path, "wb");
+    if (!io) {
+        printf("Cannot write %s: %s\n", path, SDL_GetError());
+        return false;
+    }
+    bool ok = SDL_WriteIO(io, data, size) == size;
+    SDL_CloseIO(io);
+    return ok;
+}
+
+static bool savePPM(const SoftRenderer& r, const char* path) {
+    char header[64];
+    int len = SDL_snprintf(header, sizeof(header), "P6\n%d %d\n255\n", r.w, r.h);
+    std::vector<Uint8> out(header, header + len);
+    out.reserve(out.size() + (size_t)r.w * r.h * 3);
+    for (Uint32 p : r.framebuffer) {
+        out.push_back((Uint8)(p & 0xFF));
+        out.push_back((Uint8)((p >> 8) & 0xFF));
+        out.push_back((Uint8)((p >> 16) & 0xFF));
+    }
+    return writeFile(path, out.data(), out.size());
+}
+
+static Uint32 crc32(const Uint8* data, size_t n, Uint32 crc = 0) {
+    static Uint32 table[256];
+    static bool init = false;
+    if (!init) {
+        for (Uint32 i = 0; i < 256; ++i) {
+            Uint32 c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        init = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void putBE32(std::vector<Uint8>& out, Uint32 v) {
+    out.push_back((Uint8)(v >> 24));
+    out.push_back((Uint8)(v >> 16));
+    out.push_back((Uint8)(v >> 8));
+    out.push_back((Uint8)v);
+}
+
+static void pngChunk(std::vector<Uint8>& out, const char* type, const std::vector<Uint8>& data) {
+    putBE32(out, (Uint32)data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    putBE32(out, crc32(&out[start], out.size() - start));
+}
+
+// uncompressed (stored deflate blocks) RGBA PNG, big but needs no zlib
+static bool savePNG(const SoftRenderer& r, const char* path) {
+    std::vector<Uint8> raw;
+    raw.reserve((size_t)(r.w * 4 + 1) * r.h);
+    for (int y = 0; y < r.h; ++y) {
+        raw.push_back(0); // filter: none
+        const Uint8* row = (const Uint8*)&r.framebuffer[(size_t)y * r.w];
+        raw.insert(raw.end(), row, row + (size_t)r.w * 4);
+    }
+
+    std::vector<Uint8> z;
+    z.push_back(0x78);
+    z.push_back(0x01);
+    Uint32 s1 = 1, s2 = 0;
+    for (size_t pos = 0; pos < raw.size() || pos == 0;) {
+        size_t n = std::min<size_t>(65535, raw.size() - pos);
+        bool last = pos + n >= raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back((Uint8)(n & 0xFF));
+        z.push_back((Uint8)(n >> 8));
+        z.push_back((Uint8)(~n & 0xFF));
+        z.push_back((Uint8)((~n >> 8) & 0xFF));
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + n);
+        for (size_t i = pos; i < pos + n; ++i) {
+            s1 = (s1 + raw[i]) % 65521;
+            s2 = (s2 + s1) % 65521;
+        }
+        pos += n;
+        if (last) break;
+    }
+    putBE32(z, (s2 << 16) | s1);
+
+    std::vector<Uint8> out = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<Uint8> ihdr;
+    putBE32(ihdr, (Uint32)r.w);
+    putBE32(ihdr, (Uint32)r.h);
+    ihdr.push_back(8); // bit depth
+    ihdr.push_back(6); // RGBA
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    pngChunk(out, "IHDR", ihdr);
+    pngChunk(out, "IDAT", z);
+    pngChunk(out, "IEND", std::vector<Uint8>());
+    return writeFile(path, out.data(), out.size());
+}
+
+bool softSaveImage(const SoftRenderer& r, const char* path) {
+    if (r.framebuffer.empty()) return false;
+    const char* ext = SDL_strrchr(path, '.');
+    if (ext && SDL_strcasecmp(ext, ".png") == 0) return savePNG(r, path);
+    return savePPM(r, path);
+}
+
+// reads the next header number of a PPM, skipping whitespace and comments
+static int ppmNumber(const char*& p, const char* end) {
+    while (p < end) {
+        if (*p == '#') { while (p < end && *p != '\n') ++p; }
+        else if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+        else break;
+    }
+    int v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+    return v;
+}
+
+GoldenResult softCompareGolden(const SoftRenderer& r, const char* path, int channelTolerance) {
+    GoldenResult res{ false, 0, 0, 1.0f };
+    size_t size = 0;
+    char* data = (char*)SDL_LoadFile(path, &size);
+    if (!data) {
+        printf("Cannot read golden image %s: %s\n", path, SDL_GetError());
+        return res;
+    }
+    const char* p = data;
+    const char* end = data + size;
+    if (size < 2 || p[0] != 'P' || p[1] != '6') {
+        printf("%s: not a binary PPM\n", path);
+        SDL_free(data);
+        return res;
+    }
+    p += 2;
+    int w = ppmNumber(p, end), h = ppmNumber(p, end), maxVal = ppmNumber(p, end);
+    ++p; // single whitespace before the pixel data
+    if (w != r.w || h != r.h || maxVal != 255 || (size_t)(end - p) < (size_t)w * h * 3) {
+        printf("%s: expected %dx%d 8-bit PPM, got %dx%d (max %d)\n", path, r.w, r.h, w, h, maxVal);
+        SDL_free(data);
+        return res;
+    }
+
+    res.loaded = true;
+    const Uint8* g = (const Uint8*)p;
+    for (size_t i = 0; i < r.framebuffer.size(); ++i, g += 3) {
+        Uint32 px = r.framebuffer[i];
+        int d = std::max(std::abs((int)(px & 0xFF) - g[0]),
+                std::max(std::abs((int)((px >> 8) & 0xFF) - g[1]), std::abs((int)((px >> 16) & 0xFF) - g[2])));
+        res.maxDiff = std::max(res.maxDiff, d);
+        if (d > channelTolerance) res.mismatched++;
+    }
+    res.mismatchFraction = r.framebuffer.empty() ? 0.0f : (float)res.mismatched / (float)r.framebuffer.size();
+    SDL_free(data);
+    return res;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "renderer.h"
+
+#include <vector>
+
+// CPU rasterizer for render snapshots: the rect list plus ImGui triangles, into an RGBA8
+// framebuffer (byte order R,G,B,A). The screen is split in tiles that are binned serially
+// and filled in parallel on the job pool; opaque and blended rect spans use SSE2 when present.
+// With a window the framebuffer is blitted to the window surface at the end of the frame.
+// Sprites are sampled straight from the atlas pixels (nearest), so there is nothing to upload.
+struct SoftTexture {
+    int w = 0, h = 0;
+    std::vector<Uint32> pixels; // RGBA8
+};
+
+struct SoftTri {
+    float x[3], y[3], u[3], v[3];
+    Uint32 col[3];
+    int tex;      // index in textures, -1 = untextured
+    int clip[4];  // x0, y0, x1, y1 in pixels, exclusive max
+};
+
+struct SoftRenderer {
+    SDL_Window* window = nullptr; // nullptr = headless
+    int w = 0, h = 0;
+    std::vector<Uint32> framebuffer;
+    Uint32 clearColor = 0;
+    const SpriteAtlas* atlas = nullptr; // from the current snapshot
+
+    std::vector<SoftTexture> textures; // ImTextureID == index + 1
+    std::vector<int> freeTextures;
+
+    // per frame scratch
+    std::vector<SDL_FRect> rects;
+    std::vector<SDL_Color> colors;
+    std::vector<Uint16> sprites;
+    std::vector<SoftTri> tris;
+    std::vector<std::vector<Uint32>> tileBins; // prim ids, SOFT_PRIM_TRI bit set for triangles
+    Uint64 frameStart = 0;
+    int tilesX = 0, tilesY = 0;
+
+    // last frame stats
+    int binnedPrims = 0;
+    float rasterMs = 0.0f;
+};
+
+static const int SOFT_TILE = 64;
+static const Uint32 SOFT_PRIM_TRI = 0x80000000u;
+
+Renderer softRendererInterface(SoftRenderer& r);
+
+// output by extension: .png or anything else as binary PPM
+bool softSaveImage(const SoftRenderer& r, const char* path);
+
+struct GoldenResult {
+    bool loaded;
+    int mismatched;  // pixels with any channel off by more than the tolerance
+    int maxDiff;
+    float mismatchFraction;
+};
+
+// compares the framebuffer with a PPM (P6) golden image
+GoldenResult softCompareGolden(const SoftRenderer& r, const char* path, int channelTolerance);
@@ -0,0 +1,82 @@
+#include "render_thread.h"
+
+#include <cstdio>
+
+static const int SNAPSHOT_FRESH = 4;
+
+static int SDLCALL renderThreadMain(void* data) {
+    RenderThread& rt = *(RenderThread*)data;
+    rt.initOk = rt.renderer.init(rt.renderer.self);
+    SDL_SignalSemaphore(rt.ready);
+    if (!rt.initOk) return 1;
+
+    const double toUs = 1e6 / (double)SDL_GetPerformanceFrequency();
+    while (true) {
+        SDL_WaitSemaphore(rt.published);
+        if (SDL_GetAtomicInt(&rt.quit)) break;
+        if (!(SDL_GetAtomicInt(&rt.middle) & SNAPSHOT_FRESH)) continue;
+
+        rt.front = SDL_SetAtomicInt(&rt.middle, rt.front) & 3;
+        SDL_SignalSemaphore(rt.consumed);
+
+        RenderSnapshot& snap = rt.slots[rt.front];
+        Uint64 t0 = SDL_GetPerformanceCounter();
+        rendererDrawSnapshot(rt.renderer, snap);
+        SDL_SetAtomicInt(&rt.lastRenderUs, (int)((SDL_GetPerformanceCounter() - t0) * toUs));
+        SDL_AddAtomicInt(&rt.framesRendered, 1);
+        if (snap.liveTextures) SDL_SignalSemaphore(rt.liveDone);
+    }
+
+    rt.renderer.shutdown(rt.renderer.self);
+    return 0;
+}
+
+bool startRenderThread(RenderThread& rt, const Renderer& renderer) {
+    rt.renderer = renderer;
+    rt.initOk = false;
+    rt.back = 0;
+    rt.front = 1;
+    SDL_SetAtomicInt(&rt.middle, 2);
+    SDL_SetAtomicInt(&rt.quit, 0);
+    rt.ready = SDL_CreateSemaphore(0);
+    rt.published = SDL_CreateSemaphore(0);
+    rt.consumed = SDL_CreateSemaphore(1);
+    rt.liveDone = SDL_CreateSemaphore(0);
+
+    rt.thread = SDL_CreateThread(renderThreadMain, "render", &rt);
+    if (!rt.thread) {
+        printf("Render thread create failed: %s\n", SDL_GetError());
+        return false;
+    }
+    SDL_WaitSemaphore(rt.ready);
+    return rt.initOk;
+}
+
+void stopRenderThread(RenderThread& rt) {
+    if (rt.thread) {
+        SDL_SetAtomicInt(&rt.quit, 1);
+        SDL_SignalSemaphore(rt.published);
+        SDL_WaitThread(rt.thread, nullptr);
+        rt.thread = nullptr;
+    }
+    for (RenderSnapshot& s : rt.slots) snapshotFree(s);
+    SDL_DestroySemaphore(rt.ready);
+    SDL_DestroySemaphore(rt.published);
+    SDL_DestroySemaphore(rt.consumed);
+    SDL_DestroySemaphore(rt.liveDone);
+    rt.ready = rt.published = rt.consumed = rt.liveDone = nullptr;
+}
+
+void renderThreadPublish(RenderThread& rt) {
+    if (rt.pace) SDL_WaitSemaphore(rt.consumed);
+    else SDL_TryWaitSemaphore(rt.consumed); // keep the count bounded while pacing is off
+
+    bool live = rt.slots[rt.back].liveTextures;
+    int prev = SDL_SetAtomicInt(&rt.middle, rt.back | SNAPSHOT_FRESH);
+    if (prev & SNAPSHOT_FRESH) rt.framesDropped++;
+    rt.back = prev & 3;
+    SDL_SignalSemaphore(rt.published);
+
+    // texture uploads touch ImGui-owned data, wait until the renderer is done with them
+    if (live) SDL_WaitSemaphore(rt.liveDone);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "renderer.h"
+
+// Triple-buffered snapshot handoff: the producer fills `back`, publishing swaps it with the
+// shared middle slot, the render thread swaps the middle with its `front` when it is fresh.
+// The renderer's init/shutdown run on the render thread and bracket its lifetime, so anything
+// bound to a thread (GL context, backend objects) is created and destroyed there.
+struct RenderThread {
+    Renderer renderer;
+    bool initOk = false;
+    RenderSnapshot slots[3];
+    int back = 0;
+    int front = 1;
+    SDL_AtomicInt middle{};     // slot index | SNAPSHOT_FRESH
+    SDL_AtomicInt quit{};
+    SDL_AtomicInt lastRenderUs{};
+    SDL_AtomicInt framesRendered{};
+    int framesDropped = 0;
+    // with pacing the producer never gets more than one frame ahead of the renderer
+    bool pace = true;
+
+    SDL_Thread* thread = nullptr;
+    SDL_Semaphore* ready = nullptr;
+    SDL_Semaphore* published = nullptr;
+    SDL_Semaphore* consumed = nullptr;
+    SDL_Semaphore* liveDone = nullptr;
+};
+
+// false if the thread could not start or the renderer failed to initialize on it
+bool startRenderThread(RenderThread& rt, const Renderer& renderer);
+void stopRenderThread(RenderThread& rt);
+
+// the slot the producer may fill this frame
+static inline RenderSnapshot& renderThreadBackBuffer(RenderThread& rt) { return rt.slots[rt.back]; }
+
+// Hands the back buffer to the render thread. Blocks only when pacing is on and the renderer
+// is a full frame behind, or when the snapshot carries live ImGui textures.
+void renderThreadPublish(RenderThread& rt);
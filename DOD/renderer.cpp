@@ -0,0 +1,31 @@
+#include "renderer.h"
+
+bool parseRendererKind(const char* name, RendererKind& kind, const char** sdlDriver) {
+    if (SDL_strcmp(name, "gl") == 0) kind = RENDERER_GL;
+    else if (SDL_strcmp(name, "gl-instanced") == 0) kind = RENDERER_GL_INSTANCED;
+    else if (SDL_strcmp(name, "soft") == 0) kind = RENDERER_SOFT;
+    else if (SDL_strncmp(name, "sdl", 3) == 0 && (name[3] == 0 || name[3] == ':')) {
+        kind = RENDERER_SDL;
+        *sdlDriver = name[3] == ':' ? name + 4 : nullptr;
+    }
+    else return false;
+    return true;
+}
+
+const char* rendererKindName(RendererKind kind) {
+    switch (kind) {
+        case RENDERER_GL: return "gl";
+        case RENDERER_GL_INSTANCED: return "gl-instanced";
+        case RENDERER_SDL: return "sdl";
+        case RENDERER_SOFT: return "soft";
+    }
+    return "?";
+}
+
+void rendererDrawSnapshot(const Renderer& r, RenderSnapshot& snap) {
+    r.setAtlas(r.self, snap.atlas);
+    r.beginFrame(r.self, snap.viewW, snap.viewH);
+    if (!snap.rects.empty()) r.drawRects(r.self, snap.rects.data(), snap.colors.data(), snap.sprites.data(), snap.rects.size());
+    r.drawImGui(r.self, &snap.imgui);
+    r.endFrame(r.self);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "render_snapshot.h"
+
+// Render backend interface. The simulation only fills snapshots and hands them to one of
+// these, so it never touches GL or SDL_Renderer directly. Every callback gets `self`.
+// The sprite atlas travels with the snapshots (it finishes loading after the renderer is up);
+// setAtlas uploads it whenever the pointer changes and drawRects then samples sprites[i]
+// from it tinted by colors[i]. Without an atlas every rect is flat.
+struct Renderer {
+    const char* name = "";
+    bool (*init)(void* self) = nullptr; // on the thread that will render
+    void (*setAtlas)(void* self, const SpriteAtlas* atlas) = nullptr;
+    void (*beginFrame)(void* self, int viewW, int viewH) = nullptr;
+    void (*drawRects)(void* self, const SDL_FRect* rects, const SDL_Color* colors, const Uint16* sprites,
+                      size_t count) = nullptr;
+    void (*drawImGui)(void* self, ImDrawData* drawData) = nullptr;
+    void (*endFrame)(void* self) = nullptr;
+    void (*shutdown)(void* self) = nullptr;
+    void* self = nullptr;
+    // SDL_Renderer / window surface backends cannot move to the render thread
+    bool mainThreadOnly = false;
+};
+
+enum RendererKind {
+    RENDERER_GL,            // fixed-function glBegin/glEnd quads
+    RENDERER_GL_INSTANCED,  // one instanced draw from the snapshot arrays
+    RENDERER_SDL,           // SDL_Renderer + SDL_RenderGeometry
+    RENDERER_SOFT,          // CPU rasterizer, blitted to the window surface or headless
+};
+
+// "gl", "gl-instanced", "sdl", "sdl:<driver>" (e.g. sdl:software) or "soft"
+bool parseRendererKind(const char* name, RendererKind& kind, const char** sdlDriver);
+const char* rendererKindName(RendererKind kind);
+
+// atlas, begin, rect batch, ImGui, end
+void rendererDrawSnapshot(const Renderer& r, RenderSnapshot& snap);
@@ -0,0 +1,249 @@
+#include "spatial_grid.h"
+
+#include "jobs.h"
+
+#include <SDL3/SDL_intrin.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+
+void buildSpatialGrid(SpatialGrid& grid, const Vec2* points, const Uint32* ids, size_t count, float cellSize) {
+    grid.px.resize(count);
+    grid.py.resize(count);
+    grid.ids.resize(count);
+    if (count == 0) {
+        grid.cols = grid.rows = 0;
+        grid.cellStart.assign(1, 0);
+        return;
+    }
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (size_t i = 0; i < count; ++i) {
+        minX = std::min(minX, points[i].x);
+        minY = std::min(minY, points[i].y);
+        maxX = std::max(maxX, points[i].x);
+        maxY = std::max(maxY, points[i].y);
+    }
+    float extent = std::max(maxX - minX, maxY - minY);
+    grid.cellSize = std::max(cellSize, extent / (GRID_MAX_DIM - 1));
+    grid.originX = minX;
+    grid.originY = minY;
+    grid.cols = (int)((maxX - minX) / grid.cellSize) + 1;
+    grid.rows = (int)((maxY - minY) / grid.cellSize) + 1;
+
+    // counting sort by cell
+    float inv = 1.0f / grid.cellSize;
+    grid.cellStart.assign((size_t)grid.cols * grid.rows + 1, 0);
+    grid.cellOf.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        int cx = std::min(grid.cols - 1, (int)((points[i].x - minX) * inv));
+        int cy = std::min(grid.rows - 1, (int)((points[i].y - minY) * inv));
+        Uint32 cell = (Uint32)(cy * grid.cols + cx);
+        grid.cellOf[i] = cell;
+        grid.cellStart[cell + 1]++;
+    }
+    for (size_t c = 1; c < grid.cellStart.size(); ++c) grid.cellStart[c] += grid.cellStart[c - 1];
+    grid.cursor.assign(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        Uint32 dst = grid.cursor[grid.cellOf[i]]++;
+        grid.px[dst] = points[i].x;
+        grid.py[dst] = points[i].y;
+        grid.ids[dst] = ids ? ids[i] : (Uint32)i;
+    }
+}
+
+// Calls visit(cellIndex) for every cell of Chebyshev ring r around (cx, cy) that lies in the grid.
+template <typename F>
+static void forRing(const SpatialGrid& g, int cx, int cy, int r, F&& visit) {
+    int y0 = cy - r, y1 = cy + r;
+    int x0 = std::max(0, cx - r), x1 = std::min(g.cols - 1, cx + r);
+    for (int y : { y0, y1 }) {
+        if (y < 0 || y >= g.rows) continue;
+        for (int x = x0; x <= x1; ++x) visit(y * g.cols + x);
+        if (r == 0) return;
+    }
+    int ys = std::max(0, y0 + 1), ye = std::min(g.rows - 1, y1 - 1);
+    for (int x : { cx - r, cx + r }) {
+        if (x < 0 || x >= g.cols) continue;
+        for (int y = ys; y <= ye; ++y) visit(y * g.cols + x);
+    }
+}
+
+// Shared ring walk: `accept(i, d2)` sees every point within maxRadius ring by ring and returns
+// the current search radius squared (shrinks as hits are found).
+template <typename F>
+static void ringSearch(const SpatialGrid& g, Vec2 p, float maxRadius, F&& accept) {
+    if (g.cols == 0) return;
+    float inv = 1.0f / g.cellSize;
+    int cx = (int)std::floor((p.x - g.originX) * inv);
+    int cy = (int)std::floor((p.y - g.originY) * inv);
+    // rings that miss the grid entirely are skipped
+    int r0 = std::max({ 0, -cx, -cy, cx - (g.cols - 1), cy - (g.rows - 1) });
+    int rMax = std::max({ cx, cy, g.cols - 1 - cx, g.rows - 1 - cy, r0 });
+    float bound2 = maxRadius * maxRadius;
+    for (int r = r0; r <= rMax; ++r) {
+        // closest any point of ring r can be
+        float ringDist = std::max(0, r - 1) * g.cellSize;
+        if (ringDist * ringDist > bound2) break;
+        forRing(g, cx, cy, r, [&](int cell) {
+            for (Uint32 i = g.cellStart[cell]; i < g.cellStart[cell + 1]; ++i) {
+                float dx = g.px[i] - p.x, dy = g.py[i] - p.y;
+                float d2 = dx * dx + dy * dy;
+                if (d2 <= bound2) bound2 = accept(i, d2);
+            }
+        });
+    }
+}
+
+NearestHit gridNearest(const SpatialGrid& grid, Vec2 p, float maxRadius) {
+    NearestHit best{ GRID_NONE, maxRadius * maxRadius, { 0.0f, 0.0f } };
+    ringSearch(grid, p, maxRadius, [&](Uint32 i, float d2) {
+        if (d2 < best.dist2 || best.id == GRID_NONE) {
+            best.id = grid.ids[i];
+            best.dist2 = d2;
+            best.pos = { grid.px[i], grid.py[i] };
+        }
+        return best.dist2;
+    });
+    return best;
+}
+
+int gridKNearest(const SpatialGrid& grid, Vec2 p, float maxRadius, int k, NearestHit* out) {
+    if (k <= 0) return 0;
+    int n = 0;
+    float limit2 = maxRadius * maxRadius;
+    ringSearch(grid, p, maxRadius, [&](Uint32 i, float d2) {
+        if (n == k && d2 >= out[n - 1].dist2) return limit2;
+        // insertion into the sorted list, dropping the farthest when full
+        int j = n < k ? n++ : k - 1;
+        while (j > 0 && out[j - 1].dist2 > d2) {
+            out[j] = out[j - 1];
+            --j;
+        }
+        out[j] = { grid.ids[i], d2, { grid.px[i], grid.py[i] } };
+        if (n == k) limit2 = out[k - 1].dist2;
+        return limit2;
+    });
+    return n;
+}
+
+void gridNearestBatch(const SpatialGrid& grid, const Vec2* points, size_t count, float maxRadius, NearestHit* out) {
+    parallelFor((int)count, 256, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) out[i] = gridNearest(grid, points[i], maxRadius);
+    });
+}
+
+// Calls test(begin, end) for each cell range overlapping the box [c - r, c + r].
+template <typename F>
+static void forCellsInBox(const SpatialGrid& g, Vec2 c, float r, F&& test) {
+    if (g.cols == 0) return;
+    float inv = 1.0f / g.cellSize;
+    int x0 = std::max(0, (int)std::floor((c.x - r - g.originX) * inv));
+    int y0 = std::max(0, (int)std::floor((c.y - r - g.originY) * inv));
+    int x1 = std::min(g.cols - 1, (int)std::floor((c.x + r - g.originX) * inv));
+    int y1 = std::min(g.rows - 1, (int)std::floor((c.y + r - g.originY) * inv));
+    if (x0 > x1 || y0 > y1) return; // box misses the grid
+    for (int y = y0; y <= y1; ++y) {
+        // cells of a row are contiguous, scan the whole span at once
+        Uint32 begin = g.cellStart[y * g.cols + x0];
+        Uint32 end = g.cellStart[y * g.cols + x1 + 1];
+        if (begin < end) test(begin, end);
+    }
+}
+
+void gridQueryCircle(const SpatialGrid& grid, Vec2 center, float radius, std::vector<Uint32>& out) {
+    float r2 = radius * radius;
+    forCellsInBox(grid, center, radius, [&](Uint32 begin, Uint32 end) {
+        const float* px = grid.px.data();
+        const float* py = grid.py.data();
+        Uint32 i = begin;
+#ifdef SDL_SSE2_INTRINSICS
+        const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), vr2 = _mm_set1_ps(r2);
+        for (; i + 4 <= end; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(px + i), cx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(py + i), cy);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            int mask = _mm_movemask_ps(_mm_cmple_ps(d2, vr2));
+            for (; mask; mask &= mask - 1) out.push_back(grid.ids[i + SDL_MostSignificantBitIndex32(mask & -mask)]);
+        }
+#endif
+        for (; i < end; ++i) {
+            float dx = px[i] - center.x, dy = py[i] - center.y;
+            if (dx * dx + dy * dy <= r2) out.push_back(grid.ids[i]);
+        }
+    });
+}
+
+void gridQueryCone(const SpatialGrid& grid, Vec2 origin, Vec2 dir, float radius, float halfAngle,
+                   std::vector<Uint32>& out) {
+    float r2 = radius * radius;
+    float cosHalf = std::cos(std::min(halfAngle, 3.14159265f));
+    // inside if |d| <= r and dot(d, dir) >= cos(half) * |d|
+    forCellsInBox(grid, origin, radius, [&](Uint32 begin, Uint32 end) {
+        const float* px = grid.px.data();
+        const float* py = grid.py.data();
+        Uint32 i = begin;
+#ifdef SDL_SSE2_INTRINSICS
+        const __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), vr2 = _mm_set1_ps(r2);
+        const __m128 dirx = _mm_set1_ps(dir.x), diry = _mm_set1_ps(dir.y), vcos = _mm_set1_ps(cosHalf);
+        for (; i + 4 <= end; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(px + i), ox);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(py + i), oy);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 dot = _mm_add_ps(_mm_mul_ps(dx, dirx), _mm_mul_ps(dy, diry));
+            __m128 in = _mm_and_ps(_mm_cmple_ps(d2, vr2), _mm_cmpge_ps(dot, _mm_mul_ps(vcos, _mm_sqrt_ps(d2))));
+            int mask = _mm_movemask_ps(in);
+            for (; mask; mask &= mask - 1) out.push_back(grid.ids[i + SDL_MostSignificantBitIndex32(mask & -mask)]);
+        }
+#endif
+        for (; i < end; ++i) {
+            float dx = px[i] - origin.x, dy = py[i] - origin.y;
+            float d2 = dx * dx + dy * dy;
+            if (d2 <= r2 && dx * dir.x + dy * dir.y >= cosHalf * std::sqrt(d2)) out.push_back(grid.ids[i]);
+        }
+    });
+}
+
+bool gridSelfCheck() {
+    int failed = 0;
+    auto check = [&](bool ok, const char* what) {
+        if (!ok) {
+            printf("grid self check failed: %s\n", what);
+            ++failed;
+        }
+    };
+
+    SpatialGrid grid;
+    std::vector<Uint32> found;
+    buildSpatialGrid(grid, nullptr, nullptr, 0, 64.0f);
+    found.clear();
+    gridQueryCircle(grid, { 0.0f, 0.0f }, 100.0f, found);
+    check(found.empty(), "circle on an empty grid");
+    check(gridNearest(grid, { 0.0f, 0.0f }, 100.0f).id == GRID_NONE, "nearest on an empty grid");
+
+    // single point: the grid bounds are one cell around it
+    Vec2 p{ 100.0f, 100.0f };
+    buildSpatialGrid(grid, &p, nullptr, 1, 64.0f);
+    found.clear();
+    gridQueryCircle(grid, { 600.0f, 100.0f }, 140.0f, found);
+    check(found.empty(), "circle right of the grid");
+    found.clear();
+    gridQueryCircle(grid, { -500.0f, -500.0f }, 10.0f, found);
+    check(found.empty(), "circle above-left of the grid");
+    found.clear();
+    gridQueryCircle(grid, { 100.0f, 900.0f }, 140.0f, found);
+    check(found.empty(), "circle below the grid");
+    found.clear();
+    gridQueryCircle(grid, { 200.0f, 100.0f }, 150.0f, found);
+    check(found.size() == 1 && found[0] == 0, "circle overlapping the grid edge");
+    found.clear();
+    gridQueryCone(grid, { 600.0f, 100.0f }, { 1.0f, 0.0f }, 140.0f, 1.0f, found);
+    check(found.empty(), "cone outside the grid");
+    found.clear();
+    gridQueryCone(grid, { 200.0f, 100.0f }, { -1.0f, 0.0f }, 150.0f, 0.5f, found);
+    check(found.size() == 1 && found[0] == 0, "cone from outside into the grid");
+    check(gridNearest(grid, { 600.0f, 100.0f }, 140.0f).id == GRID_NONE, "nearest out of range");
+    check(gridNearest(grid, { 600.0f, 100.0f }, 600.0f).id == 0, "nearest from outside the grid");
+    return failed == 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "entities.h"
+
+#include <vector>
+
+// Uniform grid broadphase over points (e.g. mob centers), rebuilt every frame with a counting
+// sort so each cell is a contiguous range. Nearest queries walk rings of cells outwards from
+// the query point and stop once the next ring cannot hold anything closer than what was found.
+struct SpatialGrid {
+    float cellSize = 64.0f;
+    float originX = 0.0f, originY = 0.0f;
+    int cols = 0, rows = 0;
+    std::vector<Uint32> cellStart; // cols * rows + 1 offsets into the arrays below
+    std::vector<float> px, py;     // positions, sorted by cell
+    std::vector<Uint32> ids;       // caller ids, sorted by cell
+
+    // build scratch
+    std::vector<Uint32> cellOf;
+    std::vector<Uint32> cursor;
+};
+
+static const Uint32 GRID_NONE = 0xFFFFFFFFu;
+static const int GRID_MAX_DIM = 512; // cells per axis, the cell size grows past that
+
+struct NearestHit {
+    Uint32 id;   // GRID_NONE if nothing within range
+    float dist2;
+    Vec2 pos;
+};
+
+// ids may be nullptr (id = point index)
+void buildSpatialGrid(SpatialGrid& grid, const Vec2* points, const Uint32* ids, size_t count, float cellSize);
+
+NearestHit gridNearest(const SpatialGrid& grid, Vec2 p, float maxRadius);
+
+// up to k hits within maxRadius, closest first; returns how many were found
+int gridKNearest(const SpatialGrid& grid, Vec2 p, float maxRadius, int k, NearestHit* out);
+
+// one nearest query per point, spread over the job pool
+void gridNearestBatch(const SpatialGrid& grid, const Vec2* points, size_t count, float maxRadius, NearestHit* out);
+
+// Area queries: append the ids of every point inside the shape to out (no ordering).
+// Cells overlapping the shape's bounds are scanned 4 points at a time.
+void gridQueryCircle(const SpatialGrid& grid, Vec2 center, float radius, std::vector<Uint32>& out);
+
+// cone from origin along dir (normalized), halfAngle in radians (up to pi)
+void gridQueryCone(const SpatialGrid& grid, Vec2 origin, Vec2 dir, float radius, float halfAngle,
+                   std::vector<Uint32>& out);
+
+// Edge cases of the queries (empty grid, shapes partly or fully outside the grid bounds),
+// run by --headless. Prints each failed case, returns false if any failed.
+bool gridSelfCheck();
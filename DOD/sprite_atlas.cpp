@@ -0,0 +1,105 @@
+#include "sprite_atlas.h"
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+#include <cstdio>
+
+static const int ATLAS_PADDING = 1;   // keeps bilinear sampling from bleeding into neighbours
+static const int ATLAS_MAX_SIZE = 4096;
+static const int WHITE_SIZE = 4;
+
+static float msSince(Uint64 start) {
+    return (float)((SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+
+// tries w x h, returns false if something did not fit
+static bool packAll(int w, int h, std::vector<stbrp_rect>& rects, std::vector<stbrp_node>& nodes) {
+    nodes.resize(w);
+    stbrp_context ctx;
+    stbrp_init_target(&ctx, w, h, nodes.data(), (int)nodes.size());
+    for (stbrp_rect& r : rects) r.was_packed = 0;
+    return stbrp_pack_rects(&ctx, rects.data(), (int)rects.size()) == 1;
+}
+
+void packSpriteAtlas(SpriteAtlas& atlas, const std::vector<SDL_Surface*>& images,
+                     const std::vector<SpriteName>& names) {
+    atlas = SpriteAtlas();
+
+    // sprite 0: plain white, flat rects sample it
+    std::vector<SDL_Surface*> surfaces;
+    surfaces.push_back(nullptr);
+    atlas.names.push_back(SpriteName{ "" });
+    for (size_t i = 0; i < images.size(); ++i) {
+        if ((int)surfaces.size() >= MAX_SPRITES) {
+            printf("More than %d sprites, rest skipped\n", MAX_SPRITES - 1);
+            break;
+        }
+        surfaces.push_back(images[i]);
+        atlas.names.push_back(names[i]);
+    }
+
+    Uint64 packStart = SDL_GetPerformanceCounter();
+    std::vector<stbrp_rect> rects(surfaces.size());
+    int area = 0;
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        int w = surfaces[i] ? surfaces[i]->w : WHITE_SIZE;
+        int h = surfaces[i] ? surfaces[i]->h : WHITE_SIZE;
+        rects[i].id = (int)i;
+        rects[i].w = w + ATLAS_PADDING * 2;
+        rects[i].h = h + ATLAS_PADDING * 2;
+        area += w * h;
+    }
+
+    std::vector<stbrp_node> nodes;
+    int size = 64;
+    while (!packAll(size, size, rects, nodes) && size < ATLAS_MAX_SIZE) size *= 2;
+
+    atlas.w = atlas.h = size;
+    atlas.pixels.assign((size_t)size * size, 0);
+    atlas.rects.resize(surfaces.size());
+    atlas.uvs.resize(surfaces.size());
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        const stbrp_rect& pr = rects[i];
+        SDL_Surface* s = surfaces[i];
+        SDL_Rect& dst = atlas.rects[i];
+        dst.w = s ? s->w : WHITE_SIZE;
+        dst.h = s ? s->h : WHITE_SIZE;
+        if (!pr.was_packed) {
+            printf("Sprite atlas full, %s drawn flat\n", atlas.names[i].str);
+            dst = atlas.rects[0];
+        }
+        else {
+            dst.x = pr.x + ATLAS_PADDING;
+            dst.y = pr.y + ATLAS_PADDING;
+            for (int y = 0; y < dst.h; ++y) {
+                Uint32* row = &atlas.pixels[(size_t)(dst.y + y) * size + dst.x];
+                if (s) SDL_memcpy(row, (const Uint8*)s->pixels + (size_t)y * s->pitch, (size_t)dst.w * 4);
+                else for (int x = 0; x < dst.w; ++x) row[x] = 0xFFFFFFFFu;
+            }
+        }
+        // half texel inset, so filtering stays inside the sprite
+        SpriteUV& uv = atlas.uvs[i];
+        uv.u0 = (dst.x + 0.5f) / size;
+        uv.v0 = (dst.y + 0.5f) / size;
+        uv.u1 = (dst.x + dst.w - 0.5f) / size;
+        uv.v1 = (dst.y + dst.h - 0.5f) / size;
+    }
+    atlas.packMs = msSince(packStart);
+    atlas.fill = (float)area / ((float)size * size);
+
+    printf("Sprite atlas: %d sprites in %dx%d (%.0f%% used), pack %.2f ms\n",
+           (int)surfaces.size() - 1, size, size, atlas.fill * 100.0f, atlas.packMs);
+}
+
+Uint16 findSprite(const SpriteAtlas& atlas, const char* name) {
+    for (size_t i = 1; i < atlas.names.size(); ++i) {
+        if (SDL_strcmp(atlas.names[i].str, name) == 0) return (Uint16)i;
+    }
+    return SPRITE_NONE;
+}
+
+void reportAtlasUpload(const char* renderer, Uint64 startTicks) {
+    printf("Sprite atlas upload (%s): %.2f ms\n", renderer, msSince(startTicks));
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <vector>
+
+// All sprites packed into one RGBA8 texture at startup (imstb_rectpack), so every entity
+// can be drawn from a single texture bind. Sprite 0 is a white texel block: flat colored
+// rects use it and render exactly as before. Sprites are grayscale and get tinted by the
+// entity color.
+struct SpriteUV {
+    float u0, v0, u1, v1;
+};
+
+struct SpriteName {
+    char str[32];
+};
+
+struct SpriteAtlas {
+    int w = 0, h = 0;
+    std::vector<Uint32> pixels; // RGBA8, byte order R,G,B,A
+    std::vector<SpriteUV> uvs;
+    std::vector<SDL_Rect> rects; // pixel area of each sprite in the atlas
+    std::vector<SpriteName> names;
+
+    // startup report
+    float packMs = 0.0f;
+    float fill = 0.0f; // packed area / atlas area
+};
+
+static const Uint16 SPRITE_NONE = 0;
+// uniform array size in the instanced shader
+static const int MAX_SPRITES = 128;
+
+// Packs RGBA32 images (e.g. from the asset loader) into a new atlas, names[i] names images[i].
+// The surfaces are only read.
+void packSpriteAtlas(SpriteAtlas& atlas, const std::vector<SDL_Surface*>& images,
+                     const std::vector<SpriteName>& names);
+
+// SPRITE_NONE if there is no sprite with that name
+Uint16 findSprite(const SpriteAtlas& atlas, const char* name);
+
+// time a renderer spent creating its copy of the atlas, printed with the startup report
+void reportAtlasUpload(const char* renderer, Uint64 startTicks);
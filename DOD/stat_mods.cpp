@@ -0,0 +1,46 @@
+#include "stat_mods.h"
+
+void setStatBase(StatStack& s, Uint8 stat, float base) {
+    s.base[stat] = base;
+    s.dirty = true;
+}
+
+void addStatModifier(StatStack& s, Uint8 stat, Uint8 op, float value, float duration) {
+    double expiresAt = duration > 0.0f ? s.time + duration : 0.0;
+    s.mods.push_back({ stat, op, value, expiresAt });
+    if (expiresAt > 0.0 && (s.nextExpiry == 0.0 || expiresAt < s.nextExpiry)) s.nextExpiry = expiresAt;
+    s.dirty = true;
+}
+
+static void removeExpired(StatStack& s) {
+    s.nextExpiry = 0.0;
+    for (size_t i = 0; i < s.mods.size();) {
+        StatModifier& m = s.mods[i];
+        if (m.expiresAt > 0.0 && m.expiresAt <= s.time) {
+            m = s.mods.back();
+            s.mods.pop_back();
+            s.dirty = true;
+            continue;
+        }
+        if (m.expiresAt > 0.0 && (s.nextExpiry == 0.0 || m.expiresAt < s.nextExpiry)) s.nextExpiry = m.expiresAt;
+        ++i;
+    }
+}
+
+bool updateStats(StatStack& s, float dt) {
+    s.time += dt;
+    if (s.nextExpiry > 0.0 && s.time >= s.nextExpiry) removeExpired(s);
+    if (!s.dirty) return false;
+
+    float add[STAT_COUNT] = {};
+    float mul[STAT_COUNT];
+    for (int i = 0; i < STAT_COUNT; ++i) mul[i] = 1.0f;
+    for (const StatModifier& m : s.mods) {
+        if (m.op == STAT_ADD) add[m.stat] += m.value;
+        else mul[m.stat] *= m.value;
+    }
+    for (int i = 0; i < STAT_COUNT; ++i) s.value[i] = (s.base[i] + add[i]) * mul[i];
+    s.dirty = false;
+    s.recomputes++;
+    return true;
+}
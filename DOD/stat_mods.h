@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <vector>
+
+enum StatId : Uint8 {
+    STAT_FIRE_RATE = 0, // shots/s
+    STAT_BULLET_SPEED,
+    STAT_BULLET_DAMAGE,
+    STAT_MOVE_SPEED,
+    STAT_COUNT
+};
+
+enum StatOp : Uint8 {
+    STAT_ADD = 0, // summed onto the base
+    STAT_MUL,     // multiplies (base + adds)
+};
+
+struct StatModifier {
+    Uint8 stat;
+    Uint8 op;
+    float value;
+    double expiresAt; // StatStack::time when it runs out, 0: permanent
+};
+
+// Base values plus the list of active modifiers, folded into cached derived values.
+// The fold runs only when the set changes (a modifier added or expired, a base value set), so
+// readers just load value[]. Expiry is tracked as the earliest deadline instead of ticking
+// every timed modifier each frame.
+struct StatStack {
+    float base[STAT_COUNT] = {};
+    float value[STAT_COUNT] = {}; // derived, valid after refreshStats
+    std::vector<StatModifier> mods;
+    double time = 0.0;
+    double nextExpiry = 0.0; // 0: nothing timed
+    bool dirty = true;
+
+    int recomputes = 0;
+};
+
+void setStatBase(StatStack& s, Uint8 stat, float base);
+void addStatModifier(StatStack& s, Uint8 stat, Uint8 op, float value, float duration);
+
+// advances time, drops expired modifiers and refolds if anything changed; returns true when
+// value[] was recomputed
+bool updateStats(StatStack& s, float dt);
+
+// (base + sum of adds) * product of muls, cached
+static inline float statValue(const StatStack& s, Uint8 stat) { return s.value[stat]; }
@@ -0,0 +1,123 @@
+#include "wave_director.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+static const int WAVE_MAX_TOKENS = 3 + 256;
+
+static int findArchetype(const std::vector<MobArchetype>& archetypes, const char* name) {
+    for (size_t i = 0; i < archetypes.size(); ++i) {
+        if (SDL_strcmp(archetypes[i].name, name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+bool parseWaveTimeline(const char* path, char* data, const std::vector<MobArchetype>& archetypes,
+                       std::vector<WaveKey>& out) {
+    out.clear();
+    if (data) {
+        int lineNo = 0;
+        char* line = data;
+        while (line && *line) {
+            char* next = SDL_strchr(line, '\n');
+            if (next) *next++ = '\0';
+            ++lineNo;
+
+            char* tok[WAVE_MAX_TOKENS];
+            int n = splitTokens(line, tok, WAVE_MAX_TOKENS);
+            if (n > 0 && tok[0][0] != '#') {
+                if (n < 3) {
+                    printf("%s:%d: skipped (expected time rate burst [name:weight ...])\n", path, lineNo);
+                }
+                else {
+                    WaveKey k;
+                    k.time = (float)SDL_atof(tok[0]);
+                    k.rate = std::max(0.0f, (float)SDL_atof(tok[1]));
+                    k.burst = std::max(0, SDL_atoi(tok[2]));
+                    for (int t = 3; t < n; ++t) {
+                        char* colon = SDL_strchr(tok[t], ':');
+                        if (colon) *colon++ = '\0';
+                        int type = findArchetype(archetypes, tok[t]);
+                        if (type < 0) {
+                            printf("%s:%d: unknown mob '%s'\n", path, lineNo, tok[t]);
+                            continue;
+                        }
+                        if (k.mix.empty()) k.mix.assign(archetypes.size(), 0.0f);
+                        k.mix[type] = colon ? std::max(0.0f, (float)SDL_atof(colon)) : 1.0f;
+                    }
+                    out.push_back(k);
+                }
+            }
+            line = next;
+        }
+    }
+
+    if (out.empty()) {
+        printf("No wave timeline loaded from %s, spawning 1 mob/s\n", path);
+        WaveKey k;
+        k.time = 0.0f;
+        k.rate = 1.0f;
+        k.burst = 0;
+        out.push_back(k);
+        return false;
+    }
+    std::stable_sort(out.begin(), out.end(), [](const WaveKey& a, const WaveKey& b) { return a.time < b.time; });
+    return true;
+}
+
+void resetWaveDirector(WaveDirector& d) {
+    d.current = -1;
+    d.queue.clear();
+    d.head = 0;
+    d.queued = 0;
+    d.accum = 0.0f;
+}
+
+static int pickFromMix(const std::vector<float>& mix, const std::vector<MobArchetype>& archetypes) {
+    if (mix.empty()) return pickMobArchetype(archetypes);
+    float total = 0.0f;
+    for (float w : mix) total += w;
+    if (total <= 0.0f) return 0;
+    float r = (std::rand() / (float)RAND_MAX) * total;
+    for (size_t i = 0; i < mix.size(); ++i) {
+        r -= mix[i];
+        if (r <= 0.0f) return (int)i;
+    }
+    return (int)mix.size() - 1;
+}
+
+void queueSpawns(WaveDirector& d, int count, const std::vector<MobArchetype>& archetypes) {
+    count = std::min(count, d.maxQueued - d.queued);
+    if (count <= 0) return;
+
+    // drop the consumed front once it dominates the buffer
+    if (d.head > 1024 && d.head * 2 > d.queue.size()) {
+        d.queue.erase(d.queue.begin(), d.queue.begin() + d.head);
+        d.head = 0;
+    }
+
+    static const std::vector<float> noMix;
+    const std::vector<float>& mix = d.current >= 0 ? d.timeline[d.current].mix : noMix;
+    for (int i = 0; i < count; ++i) {
+        int type = pickFromMix(mix, archetypes);
+        if (d.queue.size() > d.head && d.queue.back().type == type) d.queue.back().count++;
+        else d.queue.push_back({ type, 1 });
+    }
+    d.queued += count;
+}
+
+void updateWaveDirector(WaveDirector& d, float gameTime, float dt, const std::vector<MobArchetype>& archetypes) {
+    while (d.current + 1 < (int)d.timeline.size() && d.timeline[d.current + 1].time <= gameTime) {
+        ++d.current;
+        queueSpawns(d, d.timeline[d.current].burst, archetypes);
+    }
+    if (d.current < 0) return;
+
+    d.accum += d.timeline[d.current].rate * d.rateScale * dt;
+    int due = (int)d.accum;
+    if (due > 0) {
+        d.accum -= (float)due;
+        queueSpawns(d, due, archetypes);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "mob_archetypes.h"
+
+#include <vector>
+
+// One line of data/waves.txt, active from `time` until the next key
+struct WaveKey {
+    float time;
+    float rate;             // mobs per second
+    int burst;              // mobs queued once when the key becomes active
+    std::vector<float> mix; // weight per archetype, empty = weights from the archetype table
+};
+
+struct SpawnBatch {
+    int type;
+    int count;
+};
+
+// Turns the timeline into a spawn queue and drains it under a per-frame time budget,
+// so a 200 mob burst is spread over a few frames instead of spiking one.
+struct WaveDirector {
+    std::vector<WaveKey> timeline;
+    int current = -1;
+    float rateScale = 1.0f;
+    float budgetUs = 300.0f;
+    int maxQueued = 100000;
+
+    std::vector<SpawnBatch> queue;
+    size_t head = 0;
+    int queued = 0;
+    float accum = 0.0f;
+
+    // last frame stats for the debug window
+    int spawnedLastFrame = 0;
+    float spentUsLastFrame = 0.0f;
+};
+
+// Parses the timeline from text already in memory (modified in place, may be nullptr), resolving
+// mix names against the archetype table. Falls back to 1 mob/s.
+bool parseWaveTimeline(const char* path, char* text, const std::vector<MobArchetype>& archetypes,
+                       std::vector<WaveKey>& out);
+
+void resetWaveDirector(WaveDirector& d);
+
+// advances the timeline and queues the mobs due this frame
+void updateWaveDirector(WaveDirector& d, float gameTime, float dt, const std::vector<MobArchetype>& archetypes);
+
+// queues `count` mobs picked from the active mix
+void queueSpawns(WaveDirector& d, int count, const std::vector<MobArchetype>& archetypes);
+
+// Spawns queued mobs until the queue is empty, `room` mobs were spawned or the budget is used up.
+// spawn(type) is called once per mob.
+template <typename SpawnFn>
+int drainSpawnQueue(WaveDirector& d, size_t room, SpawnFn&& spawn) {
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const Uint64 budget = (Uint64)(d.budgetUs * 1e-6 * (double)SDL_GetPerformanceFrequency());
+    int spawned = 0;
+    while (d.head < d.queue.size() && (size_t)spawned < room) {
+        SpawnBatch& b = d.queue[d.head];
+        spawn(b.type);
+        ++spawned;
+        --d.queued;
+        if (--b.count == 0) ++d.head;
+        // the timer read costs more than a spawn, only check every few mobs
+        if ((spawned & 15) == 0 && SDL_GetPerformanceCounter() - start >= budget) break;
+    }
+    if (d.head == d.queue.size()) {
+        d.queue.clear();
+        d.head = 0;
+    }
+    d.spawnedLastFrame = spawned;
+    d.spentUsLastFrame = (float)((SDL_GetPerformanceCounter() - start) * 1e6 / (double)SDL_GetPerformanceFrequency());
+    return spawned;
+}
@@ -0,0 +1,90 @@
+#include "weapons.h"
+
+#include <algorithm>
+#include <cmath>
+
+const WeaponDef WEAPON_DEFS[] = {
+    // name, color, rate, count, spread, lateral, burst, gap, speed
+    { "blaster", { 255, 255, 120, 255 }, 1.0f, 1, 0.0f, 0.0f, 1, 0.0f, 1.0f },
+    { "twin", { 255, 220, 80, 255 }, 0.8f, 2, 0.0f, 12.0f, 1, 0.0f, 1.0f },
+    { "spread", { 255, 120, 200, 255 }, 0.5f, 5, 0.7f, 0.0f, 1, 0.0f, 0.9f },
+    { "burst", { 200, 255, 120, 255 }, 0.4f, 1, 0.05f, 0.0f, 4, 0.05f, 1.2f },
+    { "nova", { 180, 140, 255, 255 }, 0.25f, 16, 6.2831853f, 0.0f, 1, 0.0f, 0.7f },
+};
+const int WEAPON_DEF_COUNT = (int)SDL_arraysize(WEAPON_DEFS);
+
+// a weapon never fires more than this many volleys in one frame (long hitches)
+static const int MAX_VOLLEYS_PER_FRAME = 32;
+
+bool addWeapon(WeaponSet& ws, Uint8 def) {
+    if (ws.count == MAX_WEAPONS || def >= WEAPON_DEF_COUNT) return false;
+    Weapon w;
+    w.def = def;
+    ws.slots[ws.count++] = w;
+    return true;
+}
+
+void removeWeapon(WeaponSet& ws, int slot) {
+    if (slot < 0 || slot >= ws.count) return;
+    for (int i = slot; i + 1 < ws.count; ++i) ws.slots[i] = ws.slots[i + 1];
+    ws.count--;
+}
+
+void fireWeapons(WeaponSet& ws, float dt, bool trigger, Vec2 from, Vec2 aim, float fireRate, float bulletSpeed,
+                 const Bullet& proto, std::vector<Bullet>& bullets) {
+    // pass 1: schedule the volleys of every weapon inside [0, dt)
+    ws.pending.clear();
+    size_t total = 0;
+    for (int s = 0; s < ws.count; ++s) {
+        Weapon& w = ws.slots[s];
+        const WeaponDef& d = WEAPON_DEFS[w.def];
+        if (!trigger) {
+            w.cooldown = std::max(0.0f, w.cooldown - dt);
+            w.burstLeft = 0;
+            continue;
+        }
+        float interval = 1.0f / std::max(0.01f, fireRate * d.rateScale);
+        int burstCount = std::max(1, d.burstCount);
+        // at high fire rates the burst is squeezed so it still ends before the next one starts
+        float burstGap = std::min(d.burstGap, interval / burstCount);
+        float t = w.cooldown;
+        int n = 0;
+        while (t < dt && n < MAX_VOLLEYS_PER_FRAME) {
+            ws.pending.push_back({ (Uint8)s, dt - t });
+            total += d.count;
+            ++n;
+            if (w.burstLeft == 0) w.burstLeft = burstCount;
+            if (--w.burstLeft > 0) t += burstGap;
+            else t += interval - burstGap * (burstCount - 1);
+        }
+        w.cooldown = std::max(0.0f, t - dt);
+    }
+
+    // pass 2: one resize, then fill
+    size_t at = bullets.size();
+    bullets.resize(at + total);
+    float baseAngle = std::atan2(aim.y, aim.x);
+    for (const WeaponSet::Volley& v : ws.pending) {
+        const WeaponDef& d = WEAPON_DEFS[ws.slots[v.slot].def];
+        float speed = bulletSpeed * d.speedScale;
+        bool fullCircle = d.spread >= 6.28f;
+        float step = d.count > 1 ? d.spread / (fullCircle ? d.count : d.count - 1) : 0.0f;
+        float first = fullCircle ? 0.0f : -0.5f * d.spread;
+        float lateralFirst = -0.5f * d.lateral * (d.count - 1);
+        for (int k = 0; k < d.count; ++k) {
+            float a = baseAngle + first + step * k;
+            Vec2 dir{ std::cos(a), std::sin(a) };
+            float off = lateralFirst + d.lateral * k;
+            // spawned where it would be now minus the dt the bullet update is about to add
+            float back = v.age - dt;
+            Bullet& b = bullets[at++];
+            b = proto;
+            b.velocity = { dir.x * speed, dir.y * speed };
+            b.rect = { from.x - aim.y * off + b.velocity.x * back - 4.0f,
+                       from.y + aim.x * off + b.velocity.y * back - 4.0f, 8.0f, 8.0f };
+            if (!proto.flags) b.color = d.color;
+        }
+    }
+    ws.volleys = (int)ws.pending.size();
+    ws.shots = (int)total;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "entities.h"
+
+#include <vector>
+
+static const int MAX_WEAPONS = 6;
+
+// One row per weapon type. A volley is `count` projectiles fanned over `spread` radians and
+// spaced `lateral` px apart; burst weapons fire burstCount volleys burstGap seconds apart.
+struct WeaponDef {
+    const char* name;
+    SDL_Color color;
+    float rateScale; // volleys (or bursts) per second, times the fire rate stat
+    int count;
+    float spread;
+    float lateral;
+    int burstCount;
+    float burstGap;
+    float speedScale;
+};
+
+extern const WeaponDef WEAPON_DEFS[];
+extern const int WEAPON_DEF_COUNT;
+
+struct Weapon {
+    Uint8 def;
+    float cooldown = 0.0f; // seconds into the next frame until the next volley, may carry over
+    int burstLeft = 0;     // volleys left in the current burst
+};
+
+struct WeaponSet {
+    Weapon slots[MAX_WEAPONS];
+    int count = 0;
+
+    // last fire
+    int volleys = 0;
+    int shots = 0;
+
+    // scratch
+    struct Volley {
+        Uint8 slot;
+        float age; // seconds between the volley and the end of the frame
+    };
+    std::vector<Volley> pending;
+};
+
+bool addWeapon(WeaponSet& ws, Uint8 def);
+void removeWeapon(WeaponSet& ws, int slot);
+
+// Advances every weapon by dt and appends all projectiles due this frame to bullets in one
+// batch. Cooldowns keep their remainder, and each projectile starts where it would be had it
+// been fired at its exact time inside the frame (bullets are moved by a full dt afterwards).
+// proto carries the shared flags/pierce/bounces; its color wins over the weapon color when
+// it has flags. With trigger off the weapons only cool down.
+void fireWeapons(WeaponSet& ws, float dt, bool trigger, Vec2 from, Vec2 aim, float fireRate, float bulletSpeed,
+                 const Bullet& proto, std::vector<Bullet>& bullets);
@@ -0,0 +1,71 @@
+#include "world.h"
+
+#include <algorithm>
+#include <cmath>
+
+void updateCamera(Camera& cam, Vec2 target, float worldW, float worldH, float dt) {
+    float tx = target.x - cam.w * 0.5f;
+    float ty = target.y - cam.h * 0.5f;
+    if (cam.follow <= 0.0f) {
+        cam.x = tx;
+        cam.y = ty;
+    }
+    else {
+        float k = 1.0f - std::exp(-cam.follow * dt);
+        cam.x += (tx - cam.x) * k;
+        cam.y += (ty - cam.y) * k;
+    }
+    cam.x = std::max(0.0f, std::min(cam.x, worldW - cam.w));
+    cam.y = std::max(0.0f, std::min(cam.y, worldH - cam.h));
+}
+
+void initWorldChunks(WorldChunks& wc, float worldW, float worldH, float chunkSize) {
+    wc.worldW = worldW;
+    wc.worldH = worldH;
+    wc.chunkSize = chunkSize;
+    wc.cols = std::max(1, (int)std::ceil(worldW / chunkSize));
+    wc.rows = std::max(1, (int)std::ceil(worldH / chunkSize));
+    wc.state.assign((size_t)wc.cols * wc.rows, CHUNK_SLEEP);
+    wc.bucketStart.assign(wc.state.size() + 1, 0);
+    wc.bucketItems.clear();
+    for (int s = 0; s < CHUNK_STATE_COUNT; ++s) wc.itemsByState[s] = wc.chunksByState[s] = 0;
+}
+
+void updateChunkStates(WorldChunks& wc, const SDL_FRect& view) {
+    float inv = 1.0f / wc.chunkSize;
+    int x0 = (int)std::floor(view.x * inv), x1 = (int)std::floor((view.x + view.w) * inv);
+    int y0 = (int)std::floor(view.y * inv), y1 = (int)std::floor((view.y + view.h) * inv);
+    for (int s = 0; s < CHUNK_STATE_COUNT; ++s) wc.chunksByState[s] = 0;
+    for (int cy = 0; cy < wc.rows; ++cy) {
+        // Chebyshev distance in chunks from the block the view touches
+        int dy = cy < y0 ? y0 - cy : cy > y1 ? cy - y1 : 0;
+        for (int cx = 0; cx < wc.cols; ++cx) {
+            int dx = cx < x0 ? x0 - cx : cx > x1 ? cx - x1 : 0;
+            int d = std::max(dx, dy);
+            Uint8 st = d <= wc.activeMargin ? CHUNK_ACTIVE : d <= wc.coarseMargin ? CHUNK_COARSE : CHUNK_SLEEP;
+            wc.state[cy * wc.cols + cx] = st;
+            wc.chunksByState[st]++;
+        }
+    }
+}
+
+void bucketByChunk(WorldChunks& wc, const SDL_FRect* first, size_t stride, size_t count) {
+    size_t chunks = wc.state.size();
+    wc.bucketStart.assign(chunks + 1, 0);
+    wc.itemChunk.resize(count);
+    const Uint8* p = (const Uint8*)first;
+    for (size_t i = 0; i < count; ++i) {
+        const SDL_FRect& r = *(const SDL_FRect*)(p + i * stride);
+        Uint32 c = (Uint32)chunkIndex(wc, r.x + r.w * 0.5f, r.y + r.h * 0.5f);
+        wc.itemChunk[i] = c;
+        wc.bucketStart[c + 1]++;
+    }
+    for (int s = 0; s < CHUNK_STATE_COUNT; ++s) wc.itemsByState[s] = 0;
+    for (size_t c = 0; c < chunks; ++c) {
+        wc.itemsByState[wc.state[c]] += (int)wc.bucketStart[c + 1];
+        wc.bucketStart[c + 1] += wc.bucketStart[c];
+    }
+    wc.cursor.assign(wc.bucketStart.begin(), wc.bucketStart.end() - 1);
+    wc.bucketItems.resize(count);
+    for (size_t i = 0; i < count; ++i) wc.bucketItems[wc.cursor[wc.itemChunk[i]]++] = (Uint32)i;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "entities.h"
+
+#include <vector>
+
+// Follows a target with exponential smoothing, clamped so it never shows outside the world.
+struct Camera {
+    float x = 0.0f, y = 0.0f; // top-left in world space
+    float w = 0.0f, h = 0.0f;
+    float follow = 8.0f; // 1/s, <= 0 snaps
+};
+
+void updateCamera(Camera& cam, Vec2 target, float worldW, float worldH, float dt);
+
+static inline SDL_FRect cameraView(const Camera& cam) { return { cam.x, cam.y, cam.w, cam.h }; }
+
+enum ChunkState : Uint8 {
+    CHUNK_ACTIVE = 0, // around the camera: full simulation
+    CHUNK_COARSE,     // further out: reduced-rate updates
+    CHUNK_SLEEP,      // everything else: not simulated at all
+    CHUNK_STATE_COUNT
+};
+
+// The world split in square chunks. Each frame the chunks get a state from their distance to
+// the camera view and entities are bucketed per chunk with a counting sort, so update loops
+// can walk only the awake buckets and sleeping chunks cost nothing.
+struct WorldChunks {
+    float worldW = 0.0f, worldH = 0.0f;
+    float chunkSize = 1024.0f;
+    int cols = 0, rows = 0;
+    int activeMargin = 1; // chunks past the ones the view touches
+    int coarseMargin = 3;
+    std::vector<Uint8> state;
+
+    // last bucketing
+    std::vector<Uint32> bucketStart; // cols * rows + 1
+    std::vector<Uint32> bucketItems; // item indices sorted by chunk
+    int itemsByState[CHUNK_STATE_COUNT];
+    int chunksByState[CHUNK_STATE_COUNT];
+
+    // scratch
+    std::vector<Uint32> itemChunk;
+    std::vector<Uint32> cursor;
+};
+
+void initWorldChunks(WorldChunks& wc, float worldW, float worldH, float chunkSize);
+
+static inline int chunkIndex(const WorldChunks& wc, float x, float y) {
+    int cx = (int)(x / wc.chunkSize), cy = (int)(y / wc.chunkSize);
+    cx = cx < 0 ? 0 : cx >= wc.cols ? wc.cols - 1 : cx;
+    cy = cy < 0 ? 0 : cy >= wc.rows ? wc.rows - 1 : cy;
+    return cy * wc.cols + cx;
+}
+
+static inline Uint8 chunkStateAt(const WorldChunks& wc, float x, float y) { return wc.state[chunkIndex(wc, x, y)]; }
+
+void updateChunkStates(WorldChunks& wc, const SDL_FRect& view);
+
+// Buckets rect centers (read at first + i * stride, like cullRects) by chunk.
+void bucketByChunk(WorldChunks& wc, const SDL_FRect* first, size_t stride, size_t count);
+
+template <typename T>
+void bucketEntities(WorldChunks& wc, const std::vector<T>& items) {
+    if (items.empty()) bucketByChunk(wc, nullptr, sizeof(T), 0);
+    else bucketByChunk(wc, &items[0].rect, sizeof(T), items.size());
+}
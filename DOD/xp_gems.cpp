@@ -0,0 +1,157 @@
+#include "xp_gems.h"
+
+#include <algorithm>
+#include <cmath>
+
+void initXpGems(XpGems& g, int capacity) {
+    g.capacity = capacity;
+    g.x.resize(capacity);
+    g.y.resize(capacity);
+    g.speed.resize(capacity);
+    g.value.resize(capacity);
+    g.flags.resize(capacity);
+    clearXpGems(g);
+}
+
+void clearXpGems(XpGems& g) {
+    g.count = 0;
+    g.active.clear();
+    g.gridDirty = true;
+}
+
+void dropXpGem(XpGems& g, float x, float y, Uint32 value) {
+    if (g.count == g.capacity) {
+        if (g.count > 0) g.value[g.count - 1] += value;
+        return;
+    }
+    int i = g.count++;
+    g.x[i] = x;
+    g.y[i] = y;
+    g.speed[i] = 0.0f;
+    g.value[i] = value;
+    g.flags[i] = 0;
+    g.gridDirty = true;
+}
+
+// stable removal of gems with value 0, rebuilds the active list on the way
+static void removeCollected(XpGems& g) {
+    int dst = 0;
+    g.active.clear();
+    for (int i = 0; i < g.count; ++i) {
+        if (g.value[i] == 0) continue;
+        if (dst != i) {
+            g.x[dst] = g.x[i];
+            g.y[dst] = g.y[i];
+            g.speed[dst] = g.speed[i];
+            g.value[dst] = g.value[i];
+            g.flags[dst] = g.flags[i];
+        }
+        if (g.flags[dst] & GEM_MAGNET) g.active.push_back((Uint32)dst);
+        ++dst;
+    }
+    g.count = dst;
+    g.gridDirty = true;
+}
+
+static void rebuildGrid(XpGems& g, float cellSize) {
+    g.points.resize(g.count);
+    for (int i = 0; i < g.count; ++i) g.points[i] = { g.x[i], g.y[i] };
+    buildSpatialGrid(g.grid, g.points.data(), nullptr, g.points.size(), cellSize);
+    g.gridDirty = false;
+}
+
+// Folds resting gems into the first resting gem of their grid cell (value-weighted position),
+// at most maxMerges of them.
+static int mergeCells(XpGems& g, int maxMerges) {
+    const SpatialGrid& grid = g.grid;
+    int merged = 0;
+    for (size_t c = 0; c + 1 < grid.cellStart.size() && merged < maxMerges; ++c) {
+        Uint32 owner = GRID_NONE;
+        for (Uint32 k = grid.cellStart[c]; k < grid.cellStart[c + 1]; ++k) {
+            Uint32 i = grid.ids[k];
+            if (g.flags[i] & GEM_MAGNET) continue;
+            if (owner == GRID_NONE) {
+                owner = i;
+                continue;
+            }
+            if (merged == maxMerges) break;
+            float total = (float)g.value[owner] + (float)g.value[i];
+            float w = (float)g.value[i] / total;
+            g.x[owner] += (g.x[i] - g.x[owner]) * w;
+            g.y[owner] += (g.y[i] - g.y[owner]) * w;
+            g.value[owner] += g.value[i];
+            g.value[i] = 0;
+            ++merged;
+        }
+    }
+    return merged;
+}
+
+static void mergeGems(XpGems& g) {
+    // a bit under the cap so merging does not run again on the next few drops
+    int target = g.mergeCap - g.mergeCap / 8;
+    float cell = g.mergeCell;
+    for (int pass = 0; pass < 8 && g.count > target; ++pass) {
+        rebuildGrid(g, cell);
+        int merged = mergeCells(g, g.count - target);
+        g.merges += merged;
+        if (merged) removeCollected(g);
+        cell *= 2.0f;
+    }
+}
+
+Uint32 updateXpGems(XpGems& g, Vec2 player, float dt) {
+    Uint64 t0 = SDL_GetPerformanceCounter();
+
+    if (g.count > g.mergeCap) mergeGems(g);
+    if (g.gridDirty) rebuildGrid(g, 64.0f);
+
+    // resting gems in range start moving; they stay flagged until collected
+    g.found.clear();
+    gridQueryCircle(g.grid, player, g.magnetRadius, g.found);
+    for (Uint32 i : g.found) {
+        if (g.flags[i] & GEM_MAGNET) continue;
+        g.flags[i] |= GEM_MAGNET;
+        g.speed[i] = g.pullSpeed;
+        g.active.push_back(i);
+    }
+
+    Uint32 picked = 0;
+    bool removed = false;
+    float collect2 = g.collectRadius * g.collectRadius;
+    for (Uint32 i : g.active) {
+        float dx = player.x - g.x[i], dy = player.y - g.y[i];
+        float d2 = dx * dx + dy * dy;
+        g.speed[i] += g.pullAccel * dt;
+        float step = g.speed[i] * dt;
+        if (d2 <= collect2 || step * step >= d2) {
+            picked += g.value[i];
+            g.value[i] = 0;
+            removed = true;
+            continue;
+        }
+        float inv = step / std::sqrt(d2);
+        g.x[i] += dx * inv;
+        g.y[i] += dy * inv;
+    }
+    if (removed) removeCollected(g);
+    g.collected += picked;
+
+    g.updateMs = (float)((SDL_GetPerformanceCounter() - t0) * 1000.0 / SDL_GetPerformanceFrequency());
+    return picked;
+}
+
+// size and color by value tier so merged gems stand out
+void xpGemsToSnapshot(const XpGems& g, RenderSnapshot& s, const SDL_FRect& view, Uint16 sprite) {
+    static const SDL_Color tiers[4] = {
+        { 80, 160, 255, 255 }, { 80, 230, 120, 255 }, { 240, 90, 90, 255 }, { 250, 210, 70, 255 },
+    };
+    for (int i = 0; i < g.count; ++i) {
+        Uint32 v = g.value[i];
+        int tier = v < 5 ? 0 : v < 25 ? 1 : v < 125 ? 2 : 3;
+        float sz = 6.0f + 2.0f * tier;
+        SDL_FRect r{ g.x[i] - sz * 0.5f, g.y[i] - sz * 0.5f, sz, sz };
+        if (!aabb(r, view)) continue;
+        snapshotAddRect(s, r, tiers[tier], sprite);
+    }
+}
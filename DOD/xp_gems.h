@@ -0,0 +1,57 @@
+#pragma once
+
+#include "entities.h"
+#include "render_snapshot.h"
+#include "spatial_grid.h"
+
+#include <vector>
+
+enum : Uint8 {
+    GEM_MAGNET = 1 << 0, // pulled towards the player, still in the grid but skipped by flag
+};
+
+// XP drops. Structure of arrays, resting gems live in a spatial grid that is only rebuilt when
+// the set changes, so a field of idle gems costs one grid query per frame (the magnet radius
+// around the player). Only magnetized gems move. When the count passes mergeCap, resting gems
+// sharing a cell are merged into one gem carrying the summed value, with the cell growing until
+// the count is back under the cap, so the cost stays flat however much is on the ground.
+struct XpGems {
+    int capacity = 0;
+    int count = 0;
+    std::vector<float> x, y;
+    std::vector<float> speed; // magnet pull speed, grows while attracted
+    std::vector<Uint32> value;
+    std::vector<Uint8> flags;
+
+    float magnetRadius = 140.0f;
+    float collectRadius = 20.0f;
+    float pullSpeed = 150.0f; // initial speed once attracted
+    float pullAccel = 900.0f;
+    int mergeCap = 8192;
+    float mergeCell = 8.0f; // starting merge cell size, doubled per pass
+
+    // state
+    SpatialGrid grid;
+    bool gridDirty = true;
+    std::vector<Uint32> active; // magnetized gems
+
+    // stats
+    Uint64 collected = 0; // total xp picked up
+    int merges = 0;       // gems removed by merging
+    float updateMs = 0.0f;
+
+    // scratch
+    std::vector<Uint32> found;
+    std::vector<Vec2> points;
+};
+
+void initXpGems(XpGems& g, int capacity);
+void clearXpGems(XpGems& g);
+
+// a drop into a full pool adds its value to the last gem instead
+void dropXpGem(XpGems& g, float x, float y, Uint32 value);
+
+// attracts and collects around the player, returns the xp picked up this frame
+Uint32 updateXpGems(XpGems& g, Vec2 player, float dt);
+
+void xpGemsToSnapshot(const XpGems& g, RenderSnapshot& s, const SDL_FRect& view, Uint16 sprite);
@@ -43,6 +43,12 @@ IMGUI_IMPL_API void     ImGui_ImplOpenGL3_DestroyDeviceObjects();
 // (Advanced) Use e.g. if you need to precisely control the timing of texture updates (e.g. for staged rendering), by setting ImDrawData::Textures = NULL to handle this manually.
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_UpdateTexture(ImTextureData* tex);
 
+// (Optional) Stream vertex/index data through an external allocator (e.g. a persistent-mapped ring buffer) instead of glBufferData() per draw list.
+// The allocator returns a write pointer into buffer '*out_buffer' at byte offset '*out_offset', or nullptr to use glBufferData() for that draw list.
+// The allocator owns synchronization with the GPU. Pass fn = nullptr to go back to the default path.
+typedef void* (*ImGui_ImplOpenGL3_StreamAllocFn)(void* user, size_t size, size_t align, unsigned int* out_buffer, size_t* out_offset);
+IMGUI_IMPL_API void     ImGui_ImplOpenGL3_SetStreamAllocator(ImGui_ImplOpenGL3_StreamAllocFn fn, void* user);
+
 // Configuration flags to add in your imconfig file:
 //#define IMGUI_IMPL_OPENGL_ES2     // Enable ES 2 (Auto-detected on Emscripten)
 //#define IMGUI_IMPL_OPENGL_ES3     // Enable ES 3 (Auto-detected on iOS/Android)